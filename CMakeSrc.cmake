@@ -2,9 +2,28 @@
 set(SOURCE_FILES_SKIP_LIST
 ${SourcePath}/skip_list.h
 ${SourcePath}/skip_list.hpp
+${SourcePath}/level_generator.h
+${SourcePath}/prefetch_policy.h
+${SourcePath}/pool_allocator.h
 ${SourcePath}/random.h
 )
 
+set(SOURCE_FILES_SKIP_MAP
+${SourcePath}/skip_map.h
+${SourcePath}/skip_map.hpp
+)
+
+set(SOURCE_FILES_SKIP_MULTISET
+${SourcePath}/skip_multiset.h
+${SourcePath}/skip_multiset.hpp
+)
+
+set(SOURCE_FILES_UNROLLED_SKIP_LIST
+${SourcePath}/unrolled_skip_list.h
+${SourcePath}/unrolled_skip_list.hpp
+${SourcePath}/key_search.h
+)
+
 set(SOURCE_FILES_TEST
 ${TestPath}/main.cpp
 ${TestPath}/tests.h
@@ -16,6 +35,9 @@ ${BenchPath}/benchmark.cpp
 
 # set appropriate source groups
 source_group(skip_list  FILES  ${SOURCE_FILES_SKIP_LIST})
+source_group(skip_map  FILES  ${SOURCE_FILES_SKIP_MAP})
+source_group(skip_multiset  FILES  ${SOURCE_FILES_SKIP_MULTISET})
+source_group(unrolled_skip_list  FILES  ${SOURCE_FILES_UNROLLED_SKIP_LIST})
 source_group(test  FILES  ${SOURCE_FILES_TEST})
 source_group(benchmark  FILES  ${SOURCE_FILES_BENCH})
 
@@ -23,9 +45,15 @@ source_group(benchmark  FILES  ${SOURCE_FILES_BENCH})
 set(SOURCE_FILES_TEST_PROJ
 ${SOURCE_FILES_TEST}
 ${SOURCE_FILES_SKIP_LIST}
+${SOURCE_FILES_SKIP_MAP}
+${SOURCE_FILES_SKIP_MULTISET}
+${SOURCE_FILES_UNROLLED_SKIP_LIST}
 )
 
 set(SOURCE_FILES_BENCH_PROJ
 ${SOURCE_FILES_BENCH}
 ${SOURCE_FILES_SKIP_LIST}
+${SOURCE_FILES_SKIP_MAP}
+${SOURCE_FILES_SKIP_MULTISET}
+${SOURCE_FILES_UNROLLED_SKIP_LIST}
 )
@@ -1,11 +1,19 @@
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <cstdlib>
 #include <iomanip>
 #include <iostream>
+#include <new>
+#include <random>
 #include <set>
 #include <string>
 #include <vector>
+#include "pool_allocator.h"
 #include "random.h"
 #include "skip_list.h"
+#include "skip_multiset.h"
+#include "unrolled_skip_list.h"
 
 size_t const StrMaxLen = 30;
 
@@ -14,6 +22,35 @@ std::vector<int>  sVectInts;
 random<int> sRand;
 using std::chrono::high_resolution_clock;
 
+// every allocation of the benchmark goes through here, see benchAllocations
+size_t sAllocations = 0;
+
+// GCC takes the free of a replaced operator delete for a mismatch with new, a false positive
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void* operator new(size_t size)
+{
+    ++sAllocations;
+    if (void* ptr = std::malloc(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
 
 void fillRandomStr(size_t count);
 void fillSeqInt(size_t count);
@@ -22,6 +59,24 @@ void benchFillRange();
 void benchFillAsc();
 void benchFillDesc();
 void benchFind();
+void benchChurn();
+void benchAllocations();
+void benchLevelGen();
+void benchFinger();
+void benchBulkBuild();
+void benchBatch();
+void benchEraseIter();
+void benchEraseRange();
+void benchIndexed();
+void benchUnrolled();
+void benchKeySearch();
+void benchCachedKeys();
+void benchPrefetch();
+void benchFindMany();
+void benchFindSorted();
+void benchSetAlgebra();
+void benchSplitJoin();
+void benchMultiset();
 
 
 /*********** MAIN ***********/
@@ -31,6 +86,24 @@ int main(int argc, char* argv[])
     benchFillAsc();
     benchFillDesc();
     benchFind();
+    benchChurn();
+    benchAllocations();
+    benchLevelGen();
+    benchFinger();
+    benchBulkBuild();
+    benchBatch();
+    benchEraseIter();
+    benchEraseRange();
+    benchIndexed();
+    benchUnrolled();
+    benchKeySearch();
+    benchCachedKeys();
+    benchPrefetch();
+    benchFindMany();
+    benchFindSorted();
+    benchSetAlgebra();
+    benchSplitJoin();
+    benchMultiset();
 
     sVect.clear();
     sVectInts.clear();
@@ -308,4 +381,1047 @@ void benchFind()
     for (auto const& t : timesFind)
         std::cout << t.second << ",\t";
     std::cout << std::endl;
-}
\ No newline at end of file
+}
+template <class SkipList>
+double churn(SkipList& sl, size_t rounds)
+{
+    auto tpStart = high_resolution_clock::now();
+    for (size_t r = 0; r < rounds; ++r)
+    {
+        for (auto const& v : sVect)
+        {
+            sl.insert(v);
+        }
+        for (auto const& v : sVect)
+        {
+            sl.erase(v);
+        }
+    }
+    auto tpFinish = high_resolution_clock::now();
+    std::chrono::duration<double> diff = tpFinish - tpStart;
+    return diff.count();
+}
+
+void benchChurn()
+{
+    std::cout << "\n\nBENCH CHURN (std::allocator vs pool_allocator)\t";
+    std::vector<std::pair<double, double>> timesChurn;
+
+    for (int c = 1; c <= 100000; c *= 10)
+    {
+        std::cout << c << " ";
+        fillRandomStr(c);
+        size_t const rounds = 1000000 / c;
+        {
+            random<float> floatRand;
+            algic::skip_list<std::string, random<float>>  sl(floatRand);
+            timesChurn.push_back(std::make_pair(churn(sl, rounds), 0.0));
+        }
+
+        {
+            random<float> floatRand;
+            algic::skip_list<std::string, random<float>, std::less<std::string>, algic::pool_allocator<std::string>>  sl(floatRand);
+            timesChurn.back().second = churn(sl, rounds);
+        }
+    }
+
+    std::cout << "\n  Insert+erase times of 10^6 elements in batches of 1, 10, 100, ... elements:\n\t";
+    for (auto const& t : timesChurn)
+        std::cout << t.first << ",  ";
+    std::cout << "\n  ";
+    for (auto const& t : timesChurn)
+        std::cout << t.second << ",\t";
+    std::cout << std::endl;
+}
+
+void benchAllocations()
+{
+    std::cout << "\n\nBENCH ALLOCATIONS PER OPERATION\t";
+    std::vector<std::pair<double, double>> allocsPerOp;
+
+    for (int c = 10; c <= 1000000; c *= 10)
+    {
+        std::cout << c << " ";
+        fillSeqInt(2 * c);
+        random<float> floatRand;
+        algic::skip_list<int, random<float>>  sl(floatRand);
+        for (int i = 0; i < c; ++i)
+        {
+            sl.insert(sVectInts[2 * i]);
+        }
+
+        size_t allocsBefore = sAllocations;
+        for (int i = 0; i < c; ++i)
+        {
+            sl.insert(sVectInts[2 * i + 1]);
+        }
+        double const perInsert = double(sAllocations - allocsBefore) / c;
+
+        allocsBefore = sAllocations;
+        for (int i = 0; i < c; ++i)
+        {
+            sl.erase(sVectInts[2 * i + 1]);
+        }
+        double const perErase = double(sAllocations - allocsBefore) / c;
+        allocsPerOp.push_back(std::make_pair(perInsert, perErase));
+    }
+
+    std::cout << "\n  Allocations per insert and per erase for 10, 100, ... elements:\n\t";
+    for (auto const& t : allocsPerOp)
+        std::cout << t.first << ",  ";
+    std::cout << "\n  ";
+    for (auto const& t : allocsPerOp)
+        std::cout << t.second << ",\t";
+    std::cout << std::endl;
+}
+
+template <class LevelGen>
+double fillInts(float prob)
+{
+    random<float> floatRand;
+    algic::skip_list<int, random<float>, std::less<int>, std::allocator<int>, LevelGen>  sl(floatRand, prob);
+    auto tpStart = high_resolution_clock::now();
+    for (auto const& v : sVectInts)
+    {
+        sl.insert(v);
+    }
+    auto tpFinish = high_resolution_clock::now();
+    std::chrono::duration<double> diff = tpFinish - tpStart;
+    return diff.count();
+}
+
+void benchLevelGen()
+{
+    std::cout << "\n\nBENCH LEVEL GENERATOR (coin_level vs word_level)\t";
+    std::vector<std::pair<double, double>> timesTable;
+    std::vector<std::pair<double, double>> timesZeros;
+
+    for (int c = 1; c <= 1000000; c *= 10)
+    {
+        std::cout << c << " ";
+        fillSeqInt(c);
+        std::shuffle(std::begin(sVectInts), std::end(sVectInts), std::mt19937());
+
+        float const probE = 0.36787944117144f;
+        timesTable.push_back(std::make_pair(fillInts<algic::coin_level>(probE), fillInts<algic::word_level>(probE)));
+        timesZeros.push_back(std::make_pair(fillInts<algic::coin_level>(0.25f), fillInts<algic::word_level>(0.25f)));
+    }
+
+    std::cout << "\n  Fill times for 1, 10, 100, ... elements, prob = 1 / e (geometric table):\n\t";
+    for (auto const& t : timesTable)
+        std::cout << t.first << ",  ";
+    std::cout << "\n  ";
+    for (auto const& t : timesTable)
+        std::cout << t.second << ",\t";
+    std::cout << "\n  Fill times for 1, 10, 100, ... elements, prob = 1 / 4 (trailing zeros):\n\t";
+    for (auto const& t : timesZeros)
+        std::cout << t.first << ",  ";
+    std::cout << "\n  ";
+    for (auto const& t : timesZeros)
+        std::cout << t.second << ",\t";
+    std::cout << std::endl;
+}
+
+template <class IterType>
+double fillFinger(IterType first, IterType last, bool finger)
+{
+    random<float> floatRand;
+    algic::skip_list<int, random<float>>  sl(floatRand);
+    sl.finger_search(finger);
+    auto tpStart = high_resolution_clock::now();
+    for (; first != last; ++first)
+    {
+        sl.insert(*first);
+    }
+    auto tpFinish = high_resolution_clock::now();
+    std::chrono::duration<double> diff = tpFinish - tpStart;
+    return diff.count();
+}
+
+double fillHinted()
+{
+    random<float> floatRand;
+    algic::skip_list<int, random<float>>  sl(floatRand);
+    auto hint = sl.cend();
+    auto tpStart = high_resolution_clock::now();
+    for (auto const& v : sVectInts)
+    {
+        hint = sl.insert(hint, v);
+    }
+    auto tpFinish = high_resolution_clock::now();
+    std::chrono::duration<double> diff = tpFinish - tpStart;
+    return diff.count();
+}
+
+void benchFinger()
+{
+    std::cout << "\n\nBENCH FINGER SEARCH (from the head vs from the finger)\t";
+    std::vector<std::pair<double, double>> timesAsc;
+    std::vector<std::pair<double, double>> timesDesc;
+    std::vector<std::pair<double, double>> timesClustered;
+    std::vector<std::pair<double, double>> timesHinted;
+
+    for (int c = 10; c <= 1000000; c *= 10)
+    {
+        std::cout << c << " ";
+        fillSeqInt(c);
+        timesAsc.push_back(std::make_pair(fillFinger(std::cbegin(sVectInts), std::cend(sVectInts), false),
+            fillFinger(std::cbegin(sVectInts), std::cend(sVectInts), true)));
+        timesDesc.push_back(std::make_pair(fillFinger(std::crbegin(sVectInts), std::crend(sVectInts), false),
+            fillFinger(std::crbegin(sVectInts), std::crend(sVectInts), true)));
+        timesHinted.push_back(std::make_pair(timesAsc.back().first, fillHinted()));
+
+        // ascending runs of 64 keys shuffled inside
+        std::mt19937 gen;
+        for (size_t i = 0; i < sVectInts.size(); i += 64)
+            std::shuffle(std::begin(sVectInts) + i, std::begin(sVectInts) + std::min(i + 64, sVectInts.size()), gen);
+        timesClustered.push_back(std::make_pair(fillFinger(std::cbegin(sVectInts), std::cend(sVectInts), false),
+            fillFinger(std::cbegin(sVectInts), std::cend(sVectInts), true)));
+    }
+
+    std::cout << "\n  Ascending fill times for 10, 100, ... elements:\n\t";
+    for (auto const& t : timesAsc)
+        std::cout << t.first << ",  ";
+    std::cout << "\n  ";
+    for (auto const& t : timesAsc)
+        std::cout << t.second << ",\t";
+    std::cout << "\n  Descending fill times for 10, 100, ... elements:\n\t";
+    for (auto const& t : timesDesc)
+        std::cout << t.first << ",  ";
+    std::cout << "\n  ";
+    for (auto const& t : timesDesc)
+        std::cout << t.second << ",\t";
+    std::cout << "\n  Clustered fill times for 10, 100, ... elements:\n\t";
+    for (auto const& t : timesClustered)
+        std::cout << t.first << ",  ";
+    std::cout << "\n  ";
+    for (auto const& t : timesClustered)
+        std::cout << t.second << ",\t";
+    std::cout << "\n  Ascending fill times, hinted by the previous element:\n\t";
+    for (auto const& t : timesHinted)
+        std::cout << t.first << ",  ";
+    std::cout << "\n  ";
+    for (auto const& t : timesHinted)
+        std::cout << t.second << ",\t";
+    std::cout << std::endl;
+}
+
+double buildInts(bool bulk)
+{
+    random<float> floatRand;
+    algic::skip_list<int, random<float>>  sl(floatRand);
+    auto tpStart = high_resolution_clock::now();
+    if (bulk)
+        sl.assign_sorted(std::cbegin(sVectInts), std::cend(sVectInts));
+    else
+        sl.insert(std::cbegin(sVectInts), std::cend(sVectInts));
+    auto tpFinish = high_resolution_clock::now();
+    std::chrono::duration<double> diff = tpFinish - tpStart;
+    return diff.count();
+}
+
+void benchBulkBuild()
+{
+    std::cout << "\n\nBENCH BULK BUILD (insert(first, last) vs assign_sorted)\t";
+    std::vector<std::pair<double, double>> timesSorted;
+    std::vector<std::pair<double, double>> timesShuffled;
+
+    for (int c = 10; c <= 1000000; c *= 10)
+    {
+        std::cout << c << " ";
+        fillSeqInt(c);
+        timesSorted.push_back(std::make_pair(buildInts(false), buildInts(true)));
+        std::shuffle(std::begin(sVectInts), std::end(sVectInts), std::mt19937());
+        timesShuffled.push_back(std::make_pair(buildInts(false), buildInts(true)));
+    }
+
+    std::cout << "\n  Build times from sorted keys for 10, 100, ... elements:\n\t";
+    for (auto const& t : timesSorted)
+        std::cout << t.first << ",  ";
+    std::cout << "\n  ";
+    for (auto const& t : timesSorted)
+        std::cout << t.second << ",\t";
+    std::cout << "\n  Build times from shuffled keys (sorted first) for 10, 100, ... elements:\n\t";
+    for (auto const& t : timesShuffled)
+        std::cout << t.first << ",  ";
+    std::cout << "\n  ";
+    for (auto const& t : timesShuffled)
+        std::cout << t.second << ",\t";
+    std::cout << std::endl;
+}
+
+double insertBatch(std::vector<int> const& batch, bool merge)
+{
+    random<float> floatRand;
+    algic::skip_list<int, random<float>>  sl(floatRand);
+    sl.assign_sorted(std::cbegin(sVectInts), std::cend(sVectInts));
+    auto tpStart = high_resolution_clock::now();
+    if (merge)
+        sl.insert_batch(std::cbegin(batch), std::cend(batch));
+    else
+        sl.insert(std::cbegin(batch), std::cend(batch));
+    auto tpFinish = high_resolution_clock::now();
+    std::chrono::duration<double> diff = tpFinish - tpStart;
+    return diff.count();
+}
+
+void benchBatch()
+{
+    std::cout << "\n\nBENCH BATCH INSERT INTO 10^6 ELEMENTS (insert(first, last) vs insert_batch)\t";
+    std::vector<std::pair<double, double>> timesBatch;
+
+    // the list holds the even numbers, the batches bring odd ones in any order
+    fillSeqInt(1000000);
+    for (auto& v : sVectInts)
+        v *= 2;
+    std::mt19937 gen;
+    for (int c = 10; c <= 100000; c *= 10)
+    {
+        std::cout << c << " ";
+        std::vector<int> batch;
+        for (int i = 0; i < c; ++i)
+            batch.push_back(int(gen() % 1000000) * 2 + 1);
+        timesBatch.push_back(std::make_pair(insertBatch(batch, false), insertBatch(batch, true)));
+    }
+
+    std::cout << "\n  Insert times of batches of 10, 100, ... elements:\n\t";
+    for (auto const& t : timesBatch)
+        std::cout << t.first << ",  ";
+    std::cout << "\n  ";
+    for (auto const& t : timesBatch)
+        std::cout << t.second << ",\t";
+    std::cout << std::endl;
+}
+
+double scanAndErase(bool byIterator)
+{
+    random<float> floatRand;
+    algic::skip_list<int, random<float>>  sl(floatRand);
+    sl.assign_sorted(std::cbegin(sVectInts), std::cend(sVectInts));
+    auto tpStart = high_resolution_clock::now();
+    for (auto it = std::begin(sl); it != std::end(sl);)
+    {
+        if (*it % 2)
+        {
+            ++it;
+        }
+        else if (byIterator)
+        {
+            it = sl.erase(it);
+        }
+        else
+        {
+            int const key = *it++;
+            sl.erase(key);
+        }
+    }
+    auto tpFinish = high_resolution_clock::now();
+    std::chrono::duration<double> diff = tpFinish - tpStart;
+    return diff.count();
+}
+
+// the same scan done by erase_if
+template <class SkipList>
+double eraseIf()
+{
+    random<float> floatRand;
+    SkipList sl(floatRand);
+    sl.assign_sorted(std::cbegin(sVectInts), std::cend(sVectInts));
+    auto tpStart = high_resolution_clock::now();
+    sl.erase_if([](int v) { return v % 2 == 0; });
+    auto tpFinish = high_resolution_clock::now();
+    std::chrono::duration<double> diff = tpFinish - tpStart;
+    return diff.count();
+}
+
+void benchEraseIter()
+{
+    std::cout << "\n\nBENCH SCAN AND ERASE (erase(key) vs erase(iterator) vs erase_if, plain and indexed)\t";
+    std::vector<std::array<double, 4>> timesErase;
+
+    for (int c = 10; c <= 1000000; c *= 10)
+    {
+        std::cout << c << " ";
+        fillSeqInt(c);
+        std::array<double, 4> const t = { { scanAndErase(false), scanAndErase(true),
+            eraseIf<algic::skip_list<int, random<float>>>(), eraseIf<algic::indexed_skip_list<int, random<float>>>() } };
+        timesErase.push_back(t);
+    }
+
+    std::cout << "\n  Times to erase every other of 10, 100, ... elements:";
+    for (size_t k = 0; k < 4; ++k)
+    {
+        std::cout << "\n  ";
+        for (auto const& t : timesErase)
+            std::cout << t[k] << ",\t";
+    }
+    std::cout << std::endl;
+}
+
+double purgeRange(bool byRange)
+{
+    random<float> floatRand;
+    algic::skip_list<int, random<float>>  sl(floatRand);
+    sl.assign_sorted(std::cbegin(sVectInts), std::cend(sVectInts));
+    int const lo = int(sVectInts.size() / 4);
+    int const hi = lo + int(sVectInts.size() / 2);
+    auto tpStart = high_resolution_clock::now();
+    if (byRange)
+    {
+        sl.erase(sl.lower_bound(lo), sl.lower_bound(hi));
+    }
+    else
+    {
+        for (int key = lo; key < hi; ++key)
+        {
+            sl.erase(key);
+        }
+    }
+    auto tpFinish = high_resolution_clock::now();
+    std::chrono::duration<double> diff = tpFinish - tpStart;
+    return diff.count();
+}
+
+void benchEraseRange()
+{
+    std::cout << "\n\nBENCH ERASE RANGE (erase(key) per element vs erase(first, last))\t";
+    std::vector<std::pair<double, double>> timesErase;
+
+    for (int c = 10; c <= 1000000; c *= 10)
+    {
+        std::cout << c << " ";
+        fillSeqInt(c);
+        timesErase.push_back(std::make_pair(purgeRange(false), purgeRange(true)));
+    }
+
+    std::cout << "\n  Times to erase the middle half of 10, 100, ... elements:\n\t";
+    for (auto const& t : timesErase)
+        std::cout << t.first << ",  ";
+    std::cout << "\n  ";
+    for (auto const& t : timesErase)
+        std::cout << t.second << ",\t";
+    std::cout << std::endl;
+}
+
+template <class SkipList>
+std::pair<double, double> fillErase()
+{
+    random<float> floatRand;
+    SkipList sl(floatRand);
+    auto tpStart = high_resolution_clock::now();
+    for (auto const& v : sVectInts)
+    {
+        sl.insert(v);
+    }
+    auto tpFinish = high_resolution_clock::now();
+    std::chrono::duration<double> fill = tpFinish - tpStart;
+
+    tpStart = high_resolution_clock::now();
+    for (auto const& v : sVectInts)
+    {
+        sl.erase(v);
+    }
+    tpFinish = high_resolution_clock::now();
+    std::chrono::duration<double> erase = tpFinish - tpStart;
+    return std::make_pair(fill.count(), erase.count());
+}
+
+void benchIndexed()
+{
+    std::cout << "\n\nBENCH INDEXED (skip_list vs indexed_skip_list)\t";
+    std::vector<std::pair<double, double>> timesFill;
+    std::vector<std::pair<double, double>> timesErase;
+
+    for (int c = 10; c <= 1000000; c *= 10)
+    {
+        std::cout << c << " ";
+        fillSeqInt(c);
+        std::shuffle(std::begin(sVectInts), std::end(sVectInts), std::mt19937());
+        auto const plain = fillErase<algic::skip_list<int, random<float>>>();
+        auto const indexed = fillErase<algic::indexed_skip_list<int, random<float>>>();
+        timesFill.push_back(std::make_pair(plain.first, indexed.first));
+        timesErase.push_back(std::make_pair(plain.second, indexed.second));
+    }
+
+    std::cout << "\n  Fill times for 10, 100, ... elements:\n\t";
+    for (auto const& t : timesFill)
+        std::cout << t.first << ",  ";
+    std::cout << "\n  ";
+    for (auto const& t : timesFill)
+        std::cout << t.second << ",\t";
+    std::cout << "\n  Erase times for 10, 100, ... elements:\n\t";
+    for (auto const& t : timesErase)
+        std::cout << t.first << ",  ";
+    std::cout << "\n  ";
+    for (auto const& t : timesErase)
+        std::cout << t.second << ",\t";
+    std::cout << std::endl;
+}
+
+// fill with shuffled keys, find each of them, scan in order, erase them all
+template <class SkipList>
+std::array<double, 4> fillFindScan()
+{
+    random<float> floatRand;
+    SkipList sl(floatRand);
+    std::array<double, 4> times;
+    long long sum = 0;
+
+    auto tpStart = high_resolution_clock::now();
+    for (auto const& v : sVectInts)
+        sl.insert(v);
+    auto tpFinish = high_resolution_clock::now();
+    times[0] = std::chrono::duration<double>(tpFinish - tpStart).count();
+
+    tpStart = high_resolution_clock::now();
+    for (auto const& v : sVectInts)
+        sum += *sl.find(v);
+    tpFinish = high_resolution_clock::now();
+    times[1] = std::chrono::duration<double>(tpFinish - tpStart).count();
+
+    tpStart = high_resolution_clock::now();
+    for (auto const& v : sl)
+        sum += v;
+    tpFinish = high_resolution_clock::now();
+    times[2] = std::chrono::duration<double>(tpFinish - tpStart).count();
+
+    tpStart = high_resolution_clock::now();
+    for (auto const& v : sVectInts)
+        sl.erase(v);
+    tpFinish = high_resolution_clock::now();
+    times[3] = std::chrono::duration<double>(tpFinish - tpStart).count();
+
+    if (sum == 42)
+        std::cout << "";
+    return times;
+}
+
+void benchUnrolled()
+{
+    std::cout << "\n\nBENCH UNROLLED (skip_list vs unrolled_skip_list)\t";
+    std::vector<std::array<double, 4>> timesPlain;
+    std::vector<std::array<double, 4>> timesUnrolled;
+
+    for (int c = 1000; c <= 1000000; c *= 10)
+    {
+        std::cout << c << " ";
+        fillSeqInt(c);
+        std::shuffle(std::begin(sVectInts), std::end(sVectInts), std::mt19937());
+        timesPlain.push_back(fillFindScan<algic::skip_list<int, random<float>>>());
+        timesUnrolled.push_back(fillFindScan<algic::unrolled_skip_list<int, random<float>>>());
+    }
+
+    char const* const names[] = { "Fill", "Find", "Scan", "Erase" };
+    for (size_t k = 0; k < 4; ++k)
+    {
+        std::cout << "\n  " << names[k] << " times for 1000, 10000, ... elements:\n\t";
+        for (auto const& t : timesPlain)
+            std::cout << t[k] << ",  ";
+        std::cout << "\n  ";
+        for (auto const& t : timesUnrolled)
+            std::cout << t[k] << ",\t";
+    }
+    std::cout << std::endl;
+}
+
+// any comparator but std::less keeps the search inside the nodes scalar
+template <class T>
+struct scalar_less : std::less<T>
+{
+};
+
+template <class SkipList, class T>
+double findShuffled(std::vector<T> const& keys, size_t rounds)
+{
+    random<float> floatRand;
+    SkipList sl(floatRand);
+    for (auto const& v : keys)
+        sl.insert(v);
+
+    long long sum = 0;
+    auto tpStart = high_resolution_clock::now();
+    for (size_t r = 0; r < rounds; ++r)
+    {
+        for (auto const& v : keys)
+            sum += *sl.find(v);
+    }
+    auto tpFinish = high_resolution_clock::now();
+    if (sum == 42)
+        std::cout << "";
+    return std::chrono::duration<double>(tpFinish - tpStart).count();
+}
+
+template <class T>
+std::pair<double, double> findScalarVector(size_t count, size_t rounds)
+{
+    std::vector<T> keys(count);
+    for (size_t i = 0; i < count; ++i)
+        keys[i] = T(i) * 3;
+    std::shuffle(std::begin(keys), std::end(keys), std::mt19937());
+    double const scalar = findShuffled<algic::unrolled_skip_list<T, random<float>, scalar_less<T>>>(keys, rounds);
+    double const vector = findShuffled<algic::unrolled_skip_list<T, random<float>>>(keys, rounds);
+    return std::make_pair(scalar, vector);
+}
+
+void benchKeySearch()
+{
+    // 10k keys stay in the cache and are looked up 100 times over, the larger lists
+    // are bound by the cache misses of the tower walk
+    std::cout << "\n\nBENCH KEY SEARCH (unrolled_skip_list, scalar vs vectorized search in the nodes)\t";
+    std::vector<std::pair<double, double>> times32;
+    std::vector<std::pair<double, double>> times64;
+
+    for (size_t c : { 10000, 1000000, 10000000 })
+    {
+        std::cout << c << " ";
+        size_t const rounds = c < 1000000 ? 100 : 1;
+        times32.push_back(findScalarVector<std::int32_t>(c, rounds));
+        times64.push_back(findScalarVector<std::int64_t>(c, rounds));
+    }
+
+    std::cout << "\n  Find times of int32 for 10k x 100, 1M, 10M elements:\n\t";
+    for (auto const& t : times32)
+        std::cout << t.first << ",  ";
+    std::cout << "\n  ";
+    for (auto const& t : times32)
+        std::cout << t.second << ",\t";
+    std::cout << "\n  Find times of int64 for 10k x 100, 1M, 10M elements:\n\t";
+    for (auto const& t : times64)
+        std::cout << t.first << ",  ";
+    std::cout << "\n  ";
+    for (auto const& t : times64)
+        std::cout << t.second << ",\t";
+    std::cout << std::endl;
+}
+
+void benchCachedKeys()
+{
+    std::cout << "\n\nBENCH CACHED KEYS (skip_list vs cached_skip_list)\t";
+    std::vector<std::pair<double, double>> timesFind;
+
+    for (size_t c = 100000; c <= 10000000; c *= 10)
+    {
+        std::cout << c << " ";
+        std::vector<int> keys(c);
+        for (size_t i = 0; i < c; ++i)
+            keys[i] = int(i) * 3;
+        std::shuffle(std::begin(keys), std::end(keys), std::mt19937());
+        double const plain = findShuffled<algic::skip_list<int, random<float>>>(keys, 1);
+        double const cached = findShuffled<algic::cached_skip_list<int, random<float>>>(keys, 1);
+        timesFind.push_back(std::make_pair(plain, cached));
+    }
+
+    std::cout << "\n  Find times for 100000, 1000000, 10000000 elements:\n\t";
+    for (auto const& t : timesFind)
+        std::cout << t.first << ",  ";
+    std::cout << "\n  ";
+    for (auto const& t : timesFind)
+        std::cout << t.second << ",\t";
+    std::cout << std::endl;
+}
+
+// fill with shuffled keys, then find each of them and scan in order
+template <class SkipList>
+std::pair<double, double> findScan()
+{
+    random<float> floatRand;
+    SkipList sl(floatRand);
+    long long sum = 0;
+    for (auto const& v : sVectInts)
+        sl.insert(v);
+
+    auto tpStart = high_resolution_clock::now();
+    for (auto const& v : sVectInts)
+        sum += *sl.find(v);
+    auto tpFinish = high_resolution_clock::now();
+    std::chrono::duration<double> find = tpFinish - tpStart;
+
+    tpStart = high_resolution_clock::now();
+    for (auto const& v : sl)
+        sum += v;
+    tpFinish = high_resolution_clock::now();
+    std::chrono::duration<double> scan = tpFinish - tpStart;
+
+    if (sum == 42)
+        std::cout << "";
+    return std::make_pair(find.count(), scan.count());
+}
+
+void benchPrefetch()
+{
+    // the lists outgrow the last level cache, so nearly every node a search or a scan
+    // steps onto is a miss
+    std::cout << "\n\nBENCH PREFETCH (skip_list with no_prefetch vs link_prefetch)\t";
+    std::vector<std::pair<double, double>> timesFind;
+    std::vector<std::pair<double, double>> timesScan;
+
+    for (int c = 4000000; c <= 8000000; c *= 2)
+    {
+        std::cout << c << " ";
+        fillSeqInt(c);
+        std::shuffle(std::begin(sVectInts), std::end(sVectInts), std::mt19937());
+        auto const off = findScan<algic::skip_list<int, random<float>>>();
+        auto const on = findScan<algic::skip_list<int, random<float>, std::less<int>, std::allocator<int>,
+            algic::coin_level, false, false, algic::link_prefetch<>>>();
+        timesFind.push_back(std::make_pair(off.first, on.first));
+        timesScan.push_back(std::make_pair(off.second, on.second));
+    }
+
+    std::cout << "\n  Find times for 4000000, 8000000 elements:\n\t";
+    for (auto const& t : timesFind)
+        std::cout << t.first << ",  ";
+    std::cout << "\n  ";
+    for (auto const& t : timesFind)
+        std::cout << t.second << ",\t";
+    std::cout << "\n  Scan times for 4000000, 8000000 elements:\n\t";
+    for (auto const& t : timesScan)
+        std::cout << t.first << ",  ";
+    std::cout << "\n  ";
+    for (auto const& t : timesScan)
+        std::cout << t.second << ",\t";
+    std::cout << std::endl;
+}
+
+void benchFindMany()
+{
+    // a million keys of the list are probed in random order, one find at a time
+    // and then a batch at a time
+    std::cout << "\n\nBENCH FIND MANY (find loop vs find_many vs contains_many)\t";
+    std::vector<std::array<double, 3>> timesFind;
+
+    for (int c : { 100000, 4000000 })
+    {
+        std::cout << c << " ";
+        fillSeqInt(c);
+        std::shuffle(std::begin(sVectInts), std::end(sVectInts), std::mt19937());
+        random<float> floatRand;
+        algic::skip_list<int, random<float>>  sl(floatRand);
+        for (auto const& v : sVectInts)
+            sl.insert(v);
+
+        std::vector<int> keys(sVectInts.begin(), sVectInts.begin() + std::min(c, 1000000));
+        std::shuffle(std::begin(keys), std::end(keys), std::mt19937(7));
+        std::vector<decltype(sl)::iterator> found(keys.size(), sl.end());
+        std::vector<bool> contained;
+        contained.reserve(keys.size());
+        std::array<double, 3> times;
+
+        auto tpStart = high_resolution_clock::now();
+        for (size_t i = 0; i < keys.size(); ++i)
+            found[i] = sl.find(keys[i]);
+        auto tpFinish = high_resolution_clock::now();
+        times[0] = std::chrono::duration<double>(tpFinish - tpStart).count();
+
+        tpStart = high_resolution_clock::now();
+        sl.find_many(std::cbegin(keys), std::cend(keys), std::begin(found));
+        tpFinish = high_resolution_clock::now();
+        times[1] = std::chrono::duration<double>(tpFinish - tpStart).count();
+
+        tpStart = high_resolution_clock::now();
+        sl.contains_many(std::cbegin(keys), std::cend(keys), std::back_inserter(contained));
+        tpFinish = high_resolution_clock::now();
+        times[2] = std::chrono::duration<double>(tpFinish - tpStart).count();
+
+        if (found.back() == sl.end() || !contained.back())
+            std::cout << "";
+        timesFind.push_back(times);
+    }
+
+    char const* const names[] = { "find", "find_many", "contains_many" };
+    std::cout << "\n  Times of 100000 probes of 100000 and 1000000 probes of 4000000 elements:";
+    for (size_t k = 0; k < 3; ++k)
+    {
+        std::cout << "\n  " << names[k] << ":\t";
+        for (auto const& t : timesFind)
+            std::cout << t[k] << ",\t";
+    }
+    std::cout << std::endl;
+}
+
+void benchFindSorted()
+{
+    // sorted probes of a list of 4000000 elements, every 4th or every 64th element of it
+    // plus as many absent keys
+    std::cout << "\n\nBENCH FIND SORTED (find loop vs find_many vs find_sorted)\t";
+    int const count = 4000000;
+    fillSeqInt(count);
+    std::shuffle(std::begin(sVectInts), std::end(sVectInts), std::mt19937());
+    random<float> floatRand;
+    algic::skip_list<int, random<float>>  sl(floatRand);
+    for (auto const& v : sVectInts)
+        sl.insert(2 * v);
+
+    std::vector<std::array<double, 3>> timesFind;
+    for (int step : { 4, 64 })
+    {
+        std::cout << step << " ";
+        std::vector<int> keys;
+        for (int k = 0; k < 2 * count; k += step)
+        {
+            keys.push_back(k);
+            keys.push_back(k + 1);
+        }
+        std::vector<decltype(sl)::iterator> found(keys.size(), sl.end());
+        std::array<double, 3> times;
+
+        auto tpStart = high_resolution_clock::now();
+        for (size_t i = 0; i < keys.size(); ++i)
+            found[i] = sl.find(keys[i]);
+        auto tpFinish = high_resolution_clock::now();
+        times[0] = std::chrono::duration<double>(tpFinish - tpStart).count();
+
+        tpStart = high_resolution_clock::now();
+        sl.find_many(std::cbegin(keys), std::cend(keys), std::begin(found));
+        tpFinish = high_resolution_clock::now();
+        times[1] = std::chrono::duration<double>(tpFinish - tpStart).count();
+
+        tpStart = high_resolution_clock::now();
+        sl.find_sorted(std::cbegin(keys), std::cend(keys), std::begin(found));
+        tpFinish = high_resolution_clock::now();
+        times[2] = std::chrono::duration<double>(tpFinish - tpStart).count();
+
+        if (found.back() == sl.end())
+            std::cout << "";
+        timesFind.push_back(times);
+    }
+
+    char const* const names[] = { "find", "find_many", "find_sorted" };
+    std::cout << "\n  Times of the probes of every 4th and every 64th element:";
+    for (size_t k = 0; k < 3; ++k)
+    {
+        std::cout << "\n  " << names[k] << ":\t";
+        for (auto const& t : timesFind)
+            std::cout << t[k] << ",\t";
+    }
+    std::cout << std::endl;
+}
+
+// every step-th of 2 * count keys in random order
+void fillSetAlgebra(algic::skip_list<int, random<float>>& sl, int count, int step)
+{
+    std::vector<int> keys;
+    for (int k = 0; k < 2 * count; k += step)
+        keys.push_back(k);
+    std::shuffle(std::begin(keys), std::end(keys), std::mt19937(step));
+    for (auto const& v : keys)
+        sl.insert(v);
+}
+
+void benchSetAlgebra()
+{
+    // a list of 1000000 keys against one of the same size and one of 1000 keys
+    std::cout << "\n\nBENCH SET ALGEBRA (find loop / std algorithm vs skip_list members)\t";
+    int const count = 1000000;
+    random<float> floatRand;
+    algic::skip_list<int, random<float>>  large(floatRand);
+    fillSetAlgebra(large, count, 2);
+    std::vector<std::array<double, 5>> times;
+
+    for (int step : { 2 * 3, 2 * count / 1000 })
+    {
+        std::cout << step << " ";
+        std::array<double, 5> t;
+        algic::skip_list<int, random<float>>  other(floatRand);
+        fillSetAlgebra(other, count, step);
+        std::vector<int> result;
+        result.reserve(other.size());
+
+        auto tpStart = high_resolution_clock::now();
+        for (auto const& v : other)
+        {
+            if (large.contains(v))
+                result.push_back(v);
+        }
+        auto tpFinish = high_resolution_clock::now();
+        t[0] = std::chrono::duration<double>(tpFinish - tpStart).count();
+
+        result.clear();
+        tpStart = high_resolution_clock::now();
+        std::set_intersection(std::cbegin(large), std::cend(large), std::cbegin(other), std::cend(other), std::back_inserter(result));
+        tpFinish = high_resolution_clock::now();
+        t[1] = std::chrono::duration<double>(tpFinish - tpStart).count();
+
+        result.clear();
+        tpStart = high_resolution_clock::now();
+        large.set_intersection(other, std::back_inserter(result));
+        tpFinish = high_resolution_clock::now();
+        t[2] = std::chrono::duration<double>(tpFinish - tpStart).count();
+
+        // in-place union of copies of both lists, key by key and then by splicing
+        {
+            algic::skip_list<int, random<float>>  target(floatRand);
+            fillSetAlgebra(target, count, 2);
+            tpStart = high_resolution_clock::now();
+            for (auto const& v : other)
+                target.insert(v);
+            tpFinish = high_resolution_clock::now();
+            t[3] = std::chrono::duration<double>(tpFinish - tpStart).count();
+        }
+        {
+            algic::skip_list<int, random<float>>  target(floatRand);
+            fillSetAlgebra(target, count, 2);
+            tpStart = high_resolution_clock::now();
+            target.merge(other);
+            tpFinish = high_resolution_clock::now();
+            t[4] = std::chrono::duration<double>(tpFinish - tpStart).count();
+        }
+        times.push_back(t);
+    }
+
+    char const* const names[] = { "intersection, find loop", "std::set_intersection", "set_intersection",
+        "union, insert loop", "merge" };
+    std::cout << "\n  Times against 333333 and 1000 keys:";
+    for (size_t k = 0; k < 5; ++k)
+    {
+        std::cout << "\n  " << names[k] << ":\t";
+        for (auto const& t : times)
+            std::cout << t[k] << ",\t";
+    }
+    std::cout << std::endl;
+}
+
+// moves the keys from cut on to another list and back by copying them
+template <class SkipList>
+void moveCut(SkipList& sl, int cut, random<float>& floatRand, std::true_type)
+{
+    SkipList right(floatRand);
+    typename SkipList::const_iterator const first = sl.lower_bound(cut);
+    right.assign_sorted(first, sl.cend());
+    sl.erase(first, sl.cend());
+    sl.insert_batch(right.cbegin(), right.cend());
+}
+
+// the same by relinking the towers, for indexed lists only
+template <class SkipList>
+void moveCut(SkipList& sl, int cut, random<float>&, std::false_type)
+{
+    SkipList right = sl.split(cut);
+    sl.join(right);
+}
+
+// moves the keys from a random cut on to another list and back, rounds times
+template <class SkipList, bool Copy>
+double splitJoin(int count, int rounds)
+{
+    random<float> floatRand;
+    SkipList sl(floatRand);
+    sl.assign_sorted(std::cbegin(sVectInts), std::cend(sVectInts));
+    std::mt19937 gen(11);
+
+    auto tpStart = high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r)
+        moveCut(sl, int(gen() % count), floatRand, std::integral_constant<bool, Copy>());
+    auto tpFinish = high_resolution_clock::now();
+    return std::chrono::duration<double>(tpFinish - tpStart).count();
+}
+
+void benchSplitJoin()
+{
+    // 100 cuts at random keys, the keys past the cut are moved off and back
+    std::cout << "\n\nBENCH SPLIT JOIN (copy vs split/join, split needs indexed_skip_list)\t";
+    std::vector<std::array<double, 3>> times;
+
+    for (int c : { 100000, 1000000 })
+    {
+        std::cout << c << " ";
+        fillSeqInt(c);
+        std::array<double, 3> t;
+        t[0] = splitJoin<algic::skip_list<int, random<float>>, true>(c, 100);
+        t[1] = splitJoin<algic::indexed_skip_list<int, random<float>>, true>(c, 100);
+        t[2] = splitJoin<algic::indexed_skip_list<int, random<float>>, false>(c, 100);
+        times.push_back(t);
+    }
+
+    char const* const names[] = { "copy", "copy, indexed", "split/join, indexed" };
+    std::cout << "\n  Times for 100000 and 1000000 elements:";
+    for (size_t k = 0; k < 3; ++k)
+    {
+        std::cout << "\n  " << names[k] << ":\t";
+        for (auto const& t : times)
+            std::cout << t[k] << ",\t";
+    }
+    std::cout << std::endl;
+}
+
+// times of an insert loop over keys, a range insert of the sorted keys, equal_range
+// over every key and erase of every key, the runs are walked to keep them honest
+template <class Multiset>
+std::array<double, 4> multisetOps(Multiset& mset, std::vector<int> const& keys, std::vector<int> const& sorted, int distinct)
+{
+    std::array<double, 4> t;
+    auto tpStart = high_resolution_clock::now();
+    for (int key : keys)
+        mset.insert(key);
+    auto tpFinish = high_resolution_clock::now();
+    t[0] = std::chrono::duration<double>(tpFinish - tpStart).count();
+
+    mset.clear();
+    tpStart = high_resolution_clock::now();
+    mset.insert(std::cbegin(sorted), std::cend(sorted));
+    tpFinish = high_resolution_clock::now();
+    t[1] = std::chrono::duration<double>(tpFinish - tpStart).count();
+
+    size_t found = 0;
+    tpStart = high_resolution_clock::now();
+    for (int key = 0; key < distinct; ++key)
+    {
+        auto const range = mset.equal_range(key);
+        found += std::distance(range.first, range.second);
+    }
+    tpFinish = high_resolution_clock::now();
+    t[2] = std::chrono::duration<double>(tpFinish - tpStart).count();
+
+    tpStart = high_resolution_clock::now();
+    for (int key = 0; key < distinct; ++key)
+        found -= mset.erase(key);
+    tpFinish = high_resolution_clock::now();
+    t[3] = std::chrono::duration<double>(tpFinish - tpStart).count();
+    if (found != 0 || !mset.empty())
+        std::cout << "multiset mismatch ";
+    return t;
+}
+
+void benchMultiset()
+{
+    // events with about 100 of them per key
+    std::cout << "\n\nBENCH MULTISET (std::multiset vs skip_multiset)\t";
+    std::vector<std::array<double, 8>> times;
+
+    for (int c : { 100000, 1000000 })
+    {
+        std::cout << c << " ";
+        int const distinct = c / 100;
+        std::mt19937 gen(17);
+        std::vector<int> keys(c);
+        for (int& key : keys)
+            key = int(gen() % distinct);
+        std::vector<int> sorted(keys);
+        std::sort(std::begin(sorted), std::end(sorted));
+
+        std::multiset<int>  st;
+        std::array<double, 4> const tSet = multisetOps(st, keys, sorted, distinct);
+        random<float> floatRand;
+        algic::skip_multiset<int, random<float>>  mset(floatRand);
+        std::array<double, 4> const tSkip = multisetOps(mset, keys, sorted, distinct);
+        std::array<double, 8> t;
+        for (size_t k = 0; k < 4; ++k)
+        {
+            t[2 * k] = tSet[k];
+            t[2 * k + 1] = tSkip[k];
+        }
+        times.push_back(t);
+    }
+
+    char const* const names[] = { "insert loop, std::multiset", "insert loop, skip_multiset",
+        "range insert, std::multiset", "range insert, skip_multiset",
+        "equal_range, std::multiset", "equal_range, skip_multiset",
+        "erase(key), std::multiset", "erase(key), skip_multiset" };
+    std::cout << "\n  Times for 100000 and 1000000 elements:";
+    for (size_t k = 0; k < 8; ++k)
+    {
+        std::cout << "\n  " << names[k] << ":\t";
+        for (auto const& t : times)
+            std::cout << t[k] << ",\t";
+    }
+    std::cout << std::endl;
+}
@@ -0,0 +1,212 @@
+#ifndef ALGORITHMIC_KEY_SEARCH_H
+#define ALGORITHMIC_KEY_SEARCH_H
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ALGORITHMIC_KEY_SEARCH_SSE2
+#endif
+#if defined(__SSE4_2__) || defined(__AVX2__)
+#define ALGORITHMIC_KEY_SEARCH_SSE42
+#endif
+#if defined(ALGORITHMIC_KEY_SEARCH_SSE2)
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+
+namespace algic
+{
+    /**********************************************************/
+    /*                  scalar_key_search                     */
+    // Bounds of key in a sorted array of keys, a binary search through Compare
+    template <class Key, class Compare>
+    struct scalar_key_search
+    {
+        template <class K>
+        static std::size_t lower(Key const* keys, std::size_t count, K const& key, Compare const& comp);
+        template <class K>
+        static std::size_t upper(Key const* keys, std::size_t count, K const& key, Compare const& comp);
+    };
+
+
+    // true if the keys can be compared a vector at a time: signed 32 or 64-bit integers
+    // ordered by std::less, on a target that has the compare instructions for them
+    template <class Key, class Compare>
+    struct simd_searchable
+    {
+        static constexpr bool ordered = std::is_same<Compare, std::less<Key>>::value
+            || std::is_same<Compare, std::less<>>::value;
+        static constexpr bool integral = std::is_integral<Key>::value && std::is_signed<Key>::value;
+#if defined(ALGORITHMIC_KEY_SEARCH_SSE42)
+        static constexpr bool value = ordered && integral && (sizeof(Key) == 4 || sizeof(Key) == 8);
+#elif defined(ALGORITHMIC_KEY_SEARCH_SSE2)
+        static constexpr bool value = ordered && integral && sizeof(Key) == 4;
+#else
+        static constexpr bool value = false;
+#endif
+    };
+
+
+    /**********************************************************/
+    /*                      key_search                        */
+    // The last step of a lookup in an unrolled_skip_list node. The index of a bound is the
+    // number of keys before it, so keys that simd_searchable admits are counted a vector at
+    // a time (AVX2 if the target has it, SSE otherwise) with no data-dependent branch but
+    // the loop exit; on arrays of a few dozen keys that beats the mispredicted branches of
+    // a binary search. Any other key, comparator or lookup type takes scalar_key_search.
+    template <class Key, class Compare, class = void>
+    struct key_search : scalar_key_search<Key, Compare>
+    {
+    };
+
+    template <class Key, class Compare>
+    struct key_search<Key, Compare, typename std::enable_if<simd_searchable<Key, Compare>::value>::type>
+        : scalar_key_search<Key, Compare>
+    {
+        using scalar_key_search<Key, Compare>::lower;
+        using scalar_key_search<Key, Compare>::upper;
+
+        static std::size_t lower(Key const* keys, std::size_t count, Key const& key, Compare const& comp);
+        static std::size_t upper(Key const* keys, std::size_t count, Key const& key, Compare const& comp);
+
+    private:
+        typedef typename std::conditional<sizeof(Key) == 4, std::int32_t, std::int64_t>::type lane_type;
+
+        // number of keys before the lower bound (Upper = false) or the upper bound (Upper = true)
+        template <bool Upper>
+        static std::size_t countBefore(std::int32_t const* keys, std::size_t count, std::int32_t key);
+        template <bool Upper>
+        static std::size_t countBefore(std::int64_t const* keys, std::size_t count, std::int64_t key);
+
+        static unsigned bitCount(unsigned mask);
+    };
+
+
+
+    /**********************************************************/
+    /*                  implementations                       */
+
+    /**********************************************************/
+    /*                  scalar_key_search                     */
+    template <class Key, class Compare>
+    template <class K>
+    std::size_t scalar_key_search<Key, Compare>::lower(Key const* keys, std::size_t count, K const& key, Compare const& comp)
+    {
+        return std::lower_bound(keys, keys + count, key, comp) - keys;
+    }
+
+    template <class Key, class Compare>
+    template <class K>
+    std::size_t scalar_key_search<Key, Compare>::upper(Key const* keys, std::size_t count, K const& key, Compare const& comp)
+    {
+        return std::upper_bound(keys, keys + count, key, comp) - keys;
+    }
+
+
+    /**********************************************************/
+    /*                      key_search                        */
+    template <class Key, class Compare>
+    std::size_t key_search<Key, Compare, typename std::enable_if<simd_searchable<Key, Compare>::value>::type>::lower(Key const* keys, std::size_t count, Key const& key, Compare const&)
+    {
+        return countBefore<false>(reinterpret_cast<lane_type const*>(keys), count, static_cast<lane_type>(key));
+    }
+
+    template <class Key, class Compare>
+    std::size_t key_search<Key, Compare, typename std::enable_if<simd_searchable<Key, Compare>::value>::type>::upper(Key const* keys, std::size_t count, Key const& key, Compare const&)
+    {
+        return countBefore<true>(reinterpret_cast<lane_type const*>(keys), count, static_cast<lane_type>(key));
+    }
+
+#if defined(ALGORITHMIC_KEY_SEARCH_SSE2)
+    template <class Key, class Compare>
+    template <bool Upper>
+    std::size_t key_search<Key, Compare, typename std::enable_if<simd_searchable<Key, Compare>::value>::type>::countBefore(std::int32_t const* keys, std::size_t count, std::int32_t key)
+    {
+        // the lanes before a bound form a prefix of every vector, as the keys are sorted,
+        // a vector with a lane past the bound is the last one to look at
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        __m256i const wideKey = _mm256_set1_epi32(key);
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256i const lanes = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(keys + i));
+            unsigned const before = Upper
+                ? ~_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(lanes, wideKey))) & 0xFFu
+                : _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(wideKey, lanes)));
+            if (before != 0xFFu)
+                return i + bitCount(before);
+        }
+#endif
+        __m128i const vecKey = _mm_set1_epi32(key);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128i const lanes = _mm_loadu_si128(reinterpret_cast<__m128i const*>(keys + i));
+            unsigned const before = Upper
+                ? ~_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(lanes, vecKey))) & 0xFu
+                : _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(vecKey, lanes)));
+            if (before != 0xFu)
+                return i + bitCount(before);
+        }
+        for (; i < count; ++i)
+        {
+            if (Upper ? key < keys[i] : !(keys[i] < key))
+                break;
+        }
+        return i;
+    }
+#endif
+
+#if defined(ALGORITHMIC_KEY_SEARCH_SSE42)
+    template <class Key, class Compare>
+    template <bool Upper>
+    std::size_t key_search<Key, Compare, typename std::enable_if<simd_searchable<Key, Compare>::value>::type>::countBefore(std::int64_t const* keys, std::size_t count, std::int64_t key)
+    {
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        __m256i const wideKey = _mm256_set1_epi64x(key);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m256i const lanes = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(keys + i));
+            unsigned const before = Upper
+                ? ~_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(lanes, wideKey))) & 0xFu
+                : _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(wideKey, lanes)));
+            if (before != 0xFu)
+                return i + bitCount(before);
+        }
+#endif
+        __m128i const vecKey = _mm_set1_epi64x(key);
+        for (; i + 2 <= count; i += 2)
+        {
+            __m128i const lanes = _mm_loadu_si128(reinterpret_cast<__m128i const*>(keys + i));
+            unsigned const before = Upper
+                ? ~_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(lanes, vecKey))) & 0x3u
+                : _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(vecKey, lanes)));
+            if (before != 0x3u)
+                return i + bitCount(before);
+        }
+        for (; i < count; ++i)
+        {
+            if (Upper ? key < keys[i] : !(keys[i] < key))
+                break;
+        }
+        return i;
+    }
+#endif
+
+    template <class Key, class Compare>
+    unsigned key_search<Key, Compare, typename std::enable_if<simd_searchable<Key, Compare>::value>::type>::bitCount(unsigned mask)
+    {
+#if defined(_MSC_VER)
+        return __popcnt(mask);
+#else
+        return __builtin_popcount(mask);
+#endif
+    }
+} // namespace algic
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef ALGORITHMIC_LEVEL_GENERATOR_H
+#define ALGORITHMIC_LEVEL_GENERATOR_H
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+
+namespace algic
+{
+    /**********************************************************/
+    /*                      coin_level                        */
+    // Flips a coin per level: every call of RandomGen yields a uniform real
+    // in [0, 1) and the tower grows while it is less than prob
+    struct coin_level
+    {
+        explicit coin_level(float prob);
+
+        float prob() const;
+
+        template <class RandomGen>
+        std::size_t operator()(RandomGen& rand, std::size_t maxHeight) const;
+
+    private:
+        float  mProb;
+    };
+
+
+    /**********************************************************/
+    /*                      word_level                        */
+    // Takes the whole height from a single 64-bit word, RandomGen::word().
+    // For prob = 1/2 and 1/4 the height is given by the count of trailing zeros,
+    // any other prob looks the word up in a precomputed geometric table.
+    struct word_level
+    {
+        explicit word_level(float prob);
+
+        float prob() const;
+
+        template <class RandomGen>
+        std::size_t operator()(RandomGen& rand, std::size_t maxHeight) const;
+
+    private:
+        static std::size_t trailingZeros(std::uint64_t word);
+
+        float  mProb;
+        // zero bits per level when prob is 1/2 or 1/4, 0 if the table is used
+        unsigned  mZerosPerLevel{ 0 };
+        // mThreshold[k] = prob^(k + 1) * 2^64: the height exceeds k + 1 if word < mThreshold[k]
+        std::array<std::uint64_t, 64>  mThreshold;
+    };
+
+
+
+    /**********************************************************/
+    /*                  implementations                       */
+
+    /**********************************************************/
+    /*                      coin_level                        */
+    inline coin_level::coin_level(float prob)
+        : mProb(prob)
+    {
+    }
+
+    inline float coin_level::prob() const
+    {
+        return mProb;
+    }
+
+    template <class RandomGen>
+    std::size_t coin_level::operator()(RandomGen& rand, std::size_t maxHeight) const
+    {
+        std::size_t count{ 1 };
+        while (count < maxHeight && rand() < mProb)
+            ++count;
+        return count;
+    }
+
+
+    /**********************************************************/
+    /*                      word_level                        */
+    inline word_level::word_level(float prob)
+        : mProb(prob)
+    {
+        if (prob == 0.5f)
+            mZerosPerLevel = 1;
+        else if (prob == 0.25f)
+            mZerosPerLevel = 2;
+
+        long double const two64 = std::ldexp(1.0L, 64);
+        long double p = 1.0L;
+        for (auto& threshold : mThreshold)
+        {
+            p *= prob;
+            long double const t = p * two64;
+            threshold = t >= two64 ? UINT64_MAX : static_cast<std::uint64_t>(t);
+        }
+    }
+
+    inline float word_level::prob() const
+    {
+        return mProb;
+    }
+
+    template <class RandomGen>
+    std::size_t word_level::operator()(RandomGen& rand, std::size_t maxHeight) const
+    {
+        std::uint64_t const word = rand.word();
+        std::size_t count{ 1 };
+        if (mZerosPerLevel)
+            count += trailingZeros(word) / mZerosPerLevel;
+        else
+        {
+            while (count < mThreshold.size() && word < mThreshold[count - 1])
+                ++count;
+        }
+        return count < maxHeight ? count : maxHeight;
+    }
+
+    inline std::size_t word_level::trailingZeros(std::uint64_t word)
+    {
+        if (!word)
+            return 64;
+#if defined(_MSC_VER)
+        unsigned long idx;
+        _BitScanForward64(&idx, word);
+        return idx;
+#else
+        return __builtin_ctzll(word);
+#endif
+    }
+} // namespace algic
+
+#endif
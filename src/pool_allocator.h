@@ -0,0 +1,236 @@
+#ifndef ALGORITHMIC_POOL_ALLOCATOR_H
+#define ALGORITHMIC_POOL_ALLOCATOR_H
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+
+namespace algic
+{
+    /**********************************************************/
+    /*                       block_pool                       */
+    // Hands out blocks carved from big slabs. Freed blocks go to a free list
+    // chosen by the block size, so skip list nodes are bucketed by tower height
+    // and recycled without going back to malloc. Slabs are only returned to
+    // the system all at once, by release() or by the destructor.
+    struct block_pool
+    {
+        block_pool(std::size_t granule, std::size_t slabSize);
+        ~block_pool();
+
+        block_pool(block_pool const&) = delete;
+        block_pool& operator=(block_pool const&) = delete;
+
+        void* allocate(std::size_t bytes);
+        void deallocate(void* ptr, std::size_t bytes);
+
+        void release();
+
+        std::size_t granule() const;
+        std::size_t slabs() const;
+
+    private:
+        struct free_block
+        {
+            free_block* mNext;
+        };
+
+        std::size_t bucket(std::size_t bytes) const;
+        void* newSlab(std::size_t bytes);
+
+        std::size_t  mGranule;
+        std::size_t  mSlabSize;
+        char*  mCur{ nullptr };
+        char*  mEnd{ nullptr };
+        std::vector<free_block*>  mFree;
+        std::vector<void*>  mSlabs;
+    };
+
+
+    /**********************************************************/
+    /*                     pool_allocator                     */
+    // Allocator over a block_pool, copies and rebound copies share the pool.
+    // A default constructed allocator creates a pool of its own.
+    template <class T>
+    struct pool_allocator
+    {
+        typedef T value_type;
+        typedef std::true_type propagate_on_container_copy_assignment;
+        typedef std::true_type propagate_on_container_move_assignment;
+        typedef std::true_type propagate_on_container_swap;
+
+        template <class U>
+        struct rebind
+        {
+            typedef pool_allocator<U> other;
+        };
+
+        explicit pool_allocator(std::size_t slabSize = 64 * 1024);
+
+        template <class U>
+        pool_allocator(pool_allocator<U> const& rhs);
+
+        T* allocate(std::size_t n);
+        void deallocate(T* ptr, std::size_t n);
+
+        // true if no other allocator shares the pool, so that release() may be called
+        bool exclusive() const;
+        // returns every slab to the system, all blocks handed out become invalid
+        void release();
+
+        template <class U>
+        bool operator==(pool_allocator<U> const& rhs) const;
+        template <class U>
+        bool operator!=(pool_allocator<U> const& rhs) const;
+
+    private:
+        template <class U>
+        friend struct pool_allocator;
+
+        std::shared_ptr<block_pool>  mPool;
+    };
+
+
+
+    /**********************************************************/
+    /*                  implementations                       */
+
+    /**********************************************************/
+    /*                       block_pool                       */
+    inline block_pool::block_pool(std::size_t granule, std::size_t slabSize)
+        : mGranule(std::max(granule, sizeof(free_block)))
+        , mSlabSize(slabSize)
+    {
+        assert((mGranule & (mGranule - 1)) == 0 && "Granule must be a power of 2");
+        assert(mGranule <= alignof(std::max_align_t) && "Over-aligned blocks are not supported");
+    }
+
+    inline block_pool::~block_pool()
+    {
+        release();
+    }
+
+    inline void* block_pool::allocate(std::size_t bytes)
+    {
+        std::size_t const idx = bucket(bytes);
+        if (idx < mFree.size() && mFree[idx])
+        {
+            free_block* block = mFree[idx];
+            mFree[idx] = block->mNext;
+            return block;
+        }
+
+        std::size_t const size = idx * mGranule;
+        if (size > mSlabSize / 4)
+            return newSlab(size);
+        if (static_cast<std::size_t>(mEnd - mCur) < size)
+        {
+            mCur = static_cast<char*>(newSlab(mSlabSize));
+            mEnd = mCur + mSlabSize;
+        }
+        void* block = mCur;
+        mCur += size;
+        return block;
+    }
+
+    inline void block_pool::deallocate(void* ptr, std::size_t bytes)
+    {
+        std::size_t const idx = bucket(bytes);
+        if (idx >= mFree.size())
+            mFree.resize(idx + 1, nullptr);
+        free_block* block = static_cast<free_block*>(ptr);
+        block->mNext = mFree[idx];
+        mFree[idx] = block;
+    }
+
+    inline void block_pool::release()
+    {
+        for (void* slab : mSlabs)
+            ::operator delete(slab);
+        mSlabs.clear();
+        mFree.clear();
+        mCur = mEnd = nullptr;
+    }
+
+    inline std::size_t block_pool::granule() const
+    {
+        return mGranule;
+    }
+
+    inline std::size_t block_pool::slabs() const
+    {
+        return mSlabs.size();
+    }
+
+    inline std::size_t block_pool::bucket(std::size_t bytes) const
+    {
+        return (std::max(bytes, std::size_t(1)) + mGranule - 1) / mGranule;
+    }
+
+    inline void* block_pool::newSlab(std::size_t bytes)
+    {
+        mSlabs.reserve(mSlabs.size() + 1);
+        void* slab = ::operator new(bytes);
+        mSlabs.push_back(slab);
+        return slab;
+    }
+
+
+    /**********************************************************/
+    /*                     pool_allocator                     */
+    template <class T>
+    pool_allocator<T>::pool_allocator(std::size_t slabSize)
+        : mPool(std::make_shared<block_pool>(std::max(alignof(T), alignof(void*)), slabSize))
+    {
+    }
+
+    template <class T>
+    template <class U>
+    pool_allocator<T>::pool_allocator(pool_allocator<U> const& rhs)
+        : mPool(rhs.mPool)
+    {
+    }
+
+    template <class T>
+    T* pool_allocator<T>::allocate(std::size_t n)
+    {
+        assert(alignof(T) <= mPool->granule() && "Pool granule is too small for the type");
+        return static_cast<T*>(mPool->allocate(n * sizeof(T)));
+    }
+
+    template <class T>
+    void pool_allocator<T>::deallocate(T* ptr, std::size_t n)
+    {
+        mPool->deallocate(ptr, n * sizeof(T));
+    }
+
+    template <class T>
+    bool pool_allocator<T>::exclusive() const
+    {
+        return mPool.use_count() == 1;
+    }
+
+    template <class T>
+    void pool_allocator<T>::release()
+    {
+        mPool->release();
+    }
+
+    template <class T>
+    template <class U>
+    bool pool_allocator<T>::operator==(pool_allocator<U> const& rhs) const
+    {
+        return mPool == rhs.mPool;
+    }
+
+    template <class T>
+    template <class U>
+    bool pool_allocator<T>::operator!=(pool_allocator<U> const& rhs) const
+    {
+        return mPool != rhs.mPool;
+    }
+} // namespace algic
+
+#endif
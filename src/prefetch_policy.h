@@ -0,0 +1,50 @@
+#ifndef ALGORITHMIC_PREFETCH_POLICY_H
+#define ALGORITHMIC_PREFETCH_POLICY_H
+#include <cstddef>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+
+namespace algic
+{
+    /**********************************************************/
+    /*                      no_prefetch                       */
+    // Leaves the nodes to the hardware: every step of a search or a scan waits
+    // for the node it moves to
+    struct no_prefetch
+    {
+        // whether a search asks for the node one level down while it compares at the current one
+        static constexpr bool search = false;
+        // number of tower levels an iterator prefetches the successors of, 0 for none
+        static constexpr std::size_t scan_levels = 0;
+    };
+
+
+    /**********************************************************/
+    /*                     link_prefetch                      */
+    // A search on level l prefetches the successor at level l - 1 of every node it stands
+    // on, so the miss of the node it would drop to overlaps the compare on level l.
+    // An iterator stepping onto a node prefetches its successors on the ScanLevels lowest
+    // levels of its tower: the next node, and about e^l nodes ahead on level l.
+    // Only the links of the node in hand are followed, so no dangling node is ever read.
+    template <std::size_t ScanLevels = 2>
+    struct link_prefetch
+    {
+        static constexpr bool search = true;
+        static constexpr std::size_t scan_levels = ScanLevels;
+    };
+
+
+    // hints the cache line at addr into all levels of the cache, never faults
+    inline void prefetch_line(void const* addr)
+    {
+#if defined(_MSC_VER)
+        _mm_prefetch(static_cast<char const*>(addr), _MM_HINT_T0);
+#else
+        __builtin_prefetch(addr, 0, 3);
+#endif
+    }
+} // namespace algic
+
+#endif
@@ -1,5 +1,6 @@
 #ifndef INCLUDE_RANDOM_H
 #define INCLUDE_RANDOM_H
+#include <cstdint>
 #include <ctime>
 #include <random>
 
@@ -18,6 +19,13 @@ struct random
         return mUniDist(mRandGen);
     }
 
+    // 64 raw random bits from two draws of the engine, see algic::word_level
+    std::uint64_t word()
+    {
+        std::uint64_t const high = mRandGen();
+        return high << 32 | mRandGen();
+    }
+
     void seed(std::mt19937::result_type val)
     {
         mRandGen.seed(val);
@@ -42,6 +50,12 @@ struct random<int>
         return mUniDist(mRandGen);
     }
 
+    std::uint64_t word()
+    {
+        std::uint64_t const high = mRandGen();
+        return high << 32 | mRandGen();
+    }
+
     void seed(std::mt19937::result_type val)
     {
         mRandGen.seed(val);
@@ -1,13 +1,24 @@
 #ifndef ALGORITHMIC_SKIP_LIST_H
 #define ALGORITHMIC_SKIP_LIST_H
+#include <array>
+#include <cstdint>
+#include <functional>
 #include <iterator>
+#include <memory>
+#include <type_traits>
+#include "level_generator.h"
+#include "prefetch_policy.h"
 
 
 namespace algic
 {
-    struct node_base;
+    template <class Key>
+    struct node;
+
+    template <class Key>
+    struct node_unit;
 
-    template <class Key, class RandomGen>//, class Compare = std::less<Key>, class Allocator = std::allocator<Key>>
+    template <class Key, class RandomGen, class Compare = std::less<Key>, class Allocator = std::allocator<Key>, class LevelGen = coin_level, bool Indexed = false, bool CachedKeys = false, class Prefetch = no_prefetch>
     struct skip_list;
     
     template <class Key>
@@ -16,18 +27,18 @@ namespace algic
     template <class Key>
     struct slist_const_iterator
     {
-        typedef std::forward_iterator_tag  iterator_category;
+        typedef std::bidirectional_iterator_tag  iterator_category;
         typedef Key  value_type;
         typedef std::ptrdiff_t  difference_type;
         typedef difference_type distance_type;	// retained
-        typedef std::remove_cv_t<Key>*  pointer;
-        typedef std::remove_cv_t<Key>&  reference;
+        typedef Key const*  pointer;
+        typedef Key const&  reference;
 
         // NOTE: no destructor, cause there's no need in special destructing procedure
         // and the only descendant slist_iterator has no data
 
-        template <class RandomGen>//, class Compare = std::less<Key>, class Allocator = std::allocator<Key>>
-        slist_const_iterator(skip_list<Key, RandomGen/*, Compare, Allocator*/> const* slist, node_base* node);
+        template <class SkipList>
+        slist_const_iterator(SkipList const* slist, node<Key>* nd);
         
 
         slist_const_iterator(slist_const_iterator const& rhs);
@@ -38,48 +49,83 @@ namespace algic
         slist_const_iterator& operator++();
         slist_const_iterator operator++(int);
 
+        slist_const_iterator& operator--();
+        slist_const_iterator operator--(int);
+
         bool operator==(slist_const_iterator const& rhs) const;
         bool operator!=(slist_const_iterator const& rhs) const;
         bool operator==(slist_iterator<Key> const& rhs) const;
         bool operator!=(slist_iterator<Key> const& rhs) const;
 
     private:
-        void const* mSlist;
-        node_base* mNode;
+        template <class, class, class, class, class, bool, bool, class>
+        friend struct skip_list;
+
+        // prefetches the successors of mNode on the lowest mScanLevels levels of its tower
+        void prefetchAhead() const;
+
+        node<Key>* mHead;
+        node<Key>* mNode;
+        std::size_t  mScanLevels; // see Prefetch::scan_levels of the list
     };
 
     template <class Key>
     struct slist_iterator : public slist_const_iterator<Key>
     {
-        template <class RandomGen>//, class Compare = std::less<Key>, class Allocator = std::allocator<Key>>
-        slist_iterator(skip_list<Key, RandomGen/*, Compare, Allocator*/> const* slist, node_base* node);
+        template <class SkipList>
+        slist_iterator(SkipList const* slist, node<Key>* nd);
     };
 
 
     /**********************************************************/
     /*                     skip_list                          */
-    template <class Key, class RandomGen>//, class Compare = std::less<Key>, class Allocator = std::allocator<Key>>
+    // LevelGen draws tower heights from RandomGen, see level_generator.h
+    // lookups accept any type comparable with Key if Compare is transparent (has is_transparent)
+    // Indexed keeps the widths of the links for positional access, see indexed_skip_list
+    // CachedKeys keeps a copy of the key each link leads to beside it, see cached_skip_list
+    // Prefetch tells searches and iterators which nodes to prefetch, see prefetch_policy.h
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
     struct skip_list
     {
         typedef Key key_type;
         typedef Key value_type;
         typedef std::size_t  size_type;
-        //typedef Compare key_compare;
-        //typedef Compare value_compare;
-        //typedef Allocator allocator_type;
+        typedef std::ptrdiff_t  difference_type;
+        typedef Compare key_compare;
+        typedef Compare value_compare;
+        typedef Allocator allocator_type;
+        typedef Prefetch prefetch_policy;
         typedef value_type& reference;
         typedef value_type const& const_reference;
-        //typedef std::allocator_traits<Allocator>::pointer pointer;
-        //typedef std::allocator_traits<Allocator>::pointer const_pointer;
+        typedef typename std::allocator_traits<Allocator>::pointer pointer;
+        typedef typename std::allocator_traits<Allocator>::const_pointer const_pointer;
         typedef slist_iterator<Key> iterator;
         typedef slist_const_iterator<Key> const_iterator;
         typedef std::pair<iterator, bool> pairib;
         typedef std::pair<iterator, iterator>  pairit;
         typedef std::pair<const_iterator, const_iterator>  paircit;
+        typedef std::reverse_iterator<iterator> reverse_iterator;
+        typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
 
-        skip_list(RandomGen& randGen, float prob = 0.36787944117144f /* prob = 1 / e */);
+        // towers never grow higher, with prob = 1 / e that is enough for e^32 elements
+        static constexpr size_t MaxHeight = 32;
+        // searches find_many keeps in flight
+        static constexpr size_t FindBatch = 32;
+
+        static_assert(!CachedKeys || (sizeof(Key) <= sizeof(void*) && std::is_trivially_copyable<Key>::value),
+            "Only trivially copyable keys that fit in a link slot can be cached in the towers");
+
+        skip_list(RandomGen& randGen, float prob = 0.36787944117144f /* prob = 1 / e */,
+            Compare const& comp = Compare(), Allocator const& alloc = Allocator());
+        // takes the elements of rhs over, rhs is left empty
+        skip_list(skip_list&& rhs);
         ~skip_list();
 
+        skip_list(skip_list const&) = delete;
+        skip_list& operator=(skip_list const&) = delete;
+
+        allocator_type get_allocator() const;
+
         iterator begin();
         const_iterator begin() const;
         const_iterator cbegin() const;
@@ -88,6 +134,16 @@ namespace algic
         const_iterator end() const;
         const_iterator cend() const;
 
+        // walk level 0 backwards, k elements cost O(k)
+        reverse_iterator rbegin();
+        const_reverse_iterator rbegin() const;
+        const_reverse_iterator crbegin() const;
+
+        reverse_iterator rend();
+        const_reverse_iterator rend() const;
+        const_reverse_iterator crend() const;
+
+        // the lists keep the generators they were built with
         void swap(skip_list& rhs);
 
         bool empty() const;
@@ -105,39 +161,300 @@ namespace algic
 
         void insert(std::initializer_list<value_type> ilist);
 
+        // replaces the content in O(n) linking the nodes in one pass, the range is expected
+        // to be sorted (equal keys are dropped), otherwise a sorted copy of it is built from;
+        // IterType is a forward iterator
+        template <class IterType>
+        void assign_sorted(IterType first, IterType last);
+
+        // inserts a batch of keys in any order: the batch is sorted and then merged into
+        // the list in one forward sweep, returns the number of keys actually inserted
+        template <class IterType>
+        size_type insert_batch(IterType first, IterType last);
+
+        // the search starts from hint and pays off when hint is an element a little before key,
+        // any other hint (or finger mode) makes it an ordinary insert
+        iterator insert(const_iterator hint, Key const& key);
+        iterator insert(const_iterator hint, Key&& key);
+
+        // builds the key inside a new node, the node is dropped if the key is already present
+        template <class... Args>
+        pairib emplace(Args&&... args);
+        template <class... Args>
+        iterator emplace_hint(const_iterator hint, Args&&... args);
+
+        // searches for key first and builds Key from it only if it is absent; unless Compare
+        // is transparent (see is_transparent) K is converted to Key once, before the search,
+        // so the comparisons do not build a temporary Key each
+        pairib try_emplace(Key const& key);
+        pairib try_emplace(Key&& key);
+        template <class K, class C = Compare, class = typename C::is_transparent>
+        pairib try_emplace(K&& key);
+
+        // O(1) on average, the node is unlinked without a search
         iterator erase(iterator pos);
         const_iterator erase(const_iterator pos);
+        // splices the whole run out at every level in one pass, O(log n) is never paid per element
+        iterator erase(const_iterator first, const_iterator last);
         size_type erase(Key const& key);
 
-        size_type count(Key const& key);
+        // erases the elements pred holds for in one pass over level 0, returns their number;
+        // every run of them is spliced out at all its levels at once, O(n) in all; if pred
+        // throws, the elements erased until then are gone and the list stays valid
+        template <class Pred>
+        size_type erase_if(Pred pred);
+
+        size_type count(Key const& key) const;
+        template <class K, class C = Compare, class = typename C::is_transparent>
+        size_type count(K const& key) const;
 
         iterator find(Key const& key);
         const_iterator find(Key const& key) const;
+        template <class K, class C = Compare, class = typename C::is_transparent>
+        iterator find(K const& key);
+        template <class K, class C = Compare, class = typename C::is_transparent>
+        const_iterator find(K const& key) const;
+        // searches forward from hint, see insert(hint, key)
+        iterator find(const_iterator hint, Key const& key);
+        const_iterator find(const_iterator hint, Key const& key) const;
+
+        pairit equal_range(Key const& key);
+        paircit equal_range(Key const& key) const;
+        template <class K, class C = Compare, class = typename C::is_transparent>
+        pairit equal_range(K const& key);
+        template <class K, class C = Compare, class = typename C::is_transparent>
+        paircit equal_range(K const& key) const;
+
+        iterator lower_bound(Key const& key);
+        const_iterator lower_bound(Key const& key) const;
+        template <class K, class C = Compare, class = typename C::is_transparent>
+        iterator lower_bound(K const& key);
+        template <class K, class C = Compare, class = typename C::is_transparent>
+        const_iterator lower_bound(K const& key) const;
+
+        iterator upper_bound(Key const& key);
+        const_iterator upper_bound(Key const& key) const;
+        template <class K, class C = Compare, class = typename C::is_transparent>
+        iterator upper_bound(K const& key);
+        template <class K, class C = Compare, class = typename C::is_transparent>
+        const_iterator upper_bound(K const& key) const;
+
+        bool contains(Key const& key) const;
+        template <class K, class C = Compare, class = typename C::is_transparent>
+        bool contains(K const& key) const;
+
+        // Batched lookups: the keys of [first, last) are searched FindBatch at a time, their
+        // searches advance in turns a link each and every node a search is about to read is
+        // prefetched, so the cache misses of the whole batch overlap instead of queueing up.
+        // out gets find(key) (or contains(key)) for each key in order, the end of the output
+        // is returned. IterType is a forward iterator, in finger mode the keys are searched
+        // one by one.
+        template <class IterType, class OutIter>
+        OutIter find_many(IterType first, IterType last, OutIter out);
+        template <class IterType, class OutIter>
+        OutIter find_many(IterType first, IterType last, OutIter out) const;
+        template <class IterType, class OutIter>
+        OutIter contains_many(IterType first, IterType last, OutIter out) const;
+        // Lookups of a sorted range of keys: each key is searched from the search path of
+        // the previous one, so the whole range costs about as much as merging it with the
+        // list, O(m log(n / m)) for m keys. out gets find(key) for each key in order, the end
+        // of the output is returned. IterType is a forward iterator; a key less than the one
+        // before it is searched from the head again. The finger is neither used nor moved.
+        template <class IterType, class OutIter>
+        OutIter find_sorted(IterType first, IterType last, OutIter out);
+        template <class IterType, class OutIter>
+        OutIter find_sorted(IterType first, IterType last, OutIter out) const;
+
+        // Set algebra with rhs in O(n + m), both lists are walked in order and out gets the
+        // result sorted; equal keys are taken from this list. The smaller list of an
+        // intersection (and this list in a difference) seeks its keys in the other one from
+        // the search path of the previous key, which gallops over long runs of the larger
+        // list through its upper levels: O(m log(n / m)) for m keys in a list of n.
+        template <class OutIter>
+        OutIter set_union(skip_list const& rhs, OutIter out) const;
+        template <class OutIter>
+        OutIter set_intersection(skip_list const& rhs, OutIter out) const;
+        // keys of this list that are not in rhs
+        template <class OutIter>
+        OutIter set_difference(skip_list const& rhs, OutIter out) const;
+
+        // In-place union, like std::set::merge: the nodes of source whose keys are absent
+        // here are unlinked from source and linked in here as they are, nothing is copied
+        // nor reallocated, the keys already present stay in source. Every key is sought from
+        // the search path of the previous one, O(m log(n / m)) for m keys of source.
+        // Iterators to the moved elements are invalidated. With allocators that are not
+        // equal the keys are copied and erased from source instead.
+        void merge(skip_list& source);
+
+        // Cuts an indexed list in two in expected O(log n): the elements not less than key
+        // are relinked level by level to a new list, which is returned and shares the
+        // generator, prob, comparator and allocator of this one. The sizes of the pieces are
+        // summed up from the widths on the search path of key; a plain list would have to
+        // count a piece element by element, so it cannot be split. Iterators compare heads,
+        // so the iterators to the moved elements are invalidated.
+        skip_list split(Key const& key);
+        template <class K, class C = Compare, class = typename C::is_transparent>
+        skip_list split(K const& key);
+        // Concatenates other to this list in expected O(log n), other is left empty. The keys
+        // of one list must all be less than those of the other, std::invalid_argument is
+        // thrown otherwise; with allocators that are not equal the keys are copied instead.
+        // Iterators into other are invalidated; if the keys of other come first, the lists
+        // trade heads and the iterators into this list, end() included, are invalidated too.
+        void join(skip_list& other);
+
+        key_compare key_comp() const;
+        value_compare value_comp() const;
+
+        // In finger mode every search starts from the path of the previous one, so a key
+        // at distance d from the last one costs O(log d) instead of O(log n). Lookups
+        // move the finger too, hence even const ones must not run concurrently then.
+        void finger_search(bool enable);
+        bool finger_search() const;
+
+        // Positional access, for indexed lists only (see indexed_skip_list): every link
+        // knows how many elements it spans, so each of these takes O(log n).
+        // the element at index k, end() if k is not less than size()
+        iterator nth(size_type k);
+        const_iterator nth(size_type k) const;
+        // index of the element at pos, size() for end()
+        size_type index_of(const_iterator pos) const;
+        // number of elements less than key
+        size_type rank(Key const& key) const;
+        template <class K, class C = Compare, class = typename C::is_transparent>
+        size_type rank(K const& key) const;
+        // number of elements in [lo, hi)
+        size_type count_range(Key const& lo, Key const& hi) const;
+        // iterator arithmetic through the widths
+        iterator advance(const_iterator pos, difference_type n);
+        difference_type distance(const_iterator first, const_iterator last) const;
 
-        pairit equal_range(const Key& key);
-        paircit equal_range(const Key& key) const;
-
-        iterator lower_bound(const Key& key);
-        const_iterator lower_bound(const Key& key) const;
-
-        iterator upper_bound(const Key& key);
-        const_iterator upper_bound(const Key& key) const;
-
-        bool contains(Key const& key);
-        
     private:
-        node_base* visit(Key const& key, std::vector<node_base*>* visited = nullptr, bool returnEqOnly = true) const;
-        bool coin() const;
+        template <class, class, class, class, class, class>
+        friend struct skip_map;
+        template <class, class, class, class, class>
+        friend struct skip_multiset;
+        template <class>
+        friend struct slist_const_iterator;
+        template <class, class>
+        friend struct smap_const_iterator;
+
+        // predecessors of a key at every level, kept on the stack by insert
+        typedef std::array<node<Key>*, MaxHeight> update_path;
+
+        // last node less than key at level 0, the head if there is none;
+        // visited gets the last such node at every level
+        template <class K>
+        node<Key>* visit(K const& key, update_path* visited = nullptr) const;
+        // the same search, started from start at level levels - 1
+        template <class K>
+        node<Key>* visitFrom(node<Key>* start, size_t levels, K const& key, update_path* visited) const;
+        // the same search, started from the finger which then moves to key
+        template <class K>
+        node<Key>* visitFinger(K const& key) const;
+        // the same search, started from path which is the search path of a key not greater than key
+        template <class K>
+        node<Key>* visitAhead(update_path& path, K const& key) const;
+        // the same search, going forward from hint if it is less than key;
+        // levels gets how many levels of visited are filled
+        template <class K>
+        node<Key>* visitHint(node<Key>* hint, K const& key, update_path* visited, size_t& levels) const;
+        template <class K>
+        node<Key>* lowerBound(K const& key) const;
+        template <class K>
+        node<Key>* findNode(K const& key) const;
+        // hands the node holding every key of [first, last) to found in order, nullptr if there is none
+        template <class IterType, class Found>
+        void findNodes(IterType first, IterType last, Found found) const;
+        // the same for a sorted range, see find_sorted
+        template <class IterType, class Found>
+        void findSortedNodes(IterType first, IterType last, Found found) const;
+        // nd is known not to be less than key
+        template <class K>
+        bool isEqual(node<Key> const* nd, K const& key) const;
+        // links in a node built from args unless an element equal to key is present,
+        // returns the node holding key and whether it is a new one
+        template <class K, class... Args>
+        std::pair<node<Key>*, bool> emplaceKey(K const& key, Args&&... args);
+        template <class K, class... Args>
+        std::pair<node<Key>*, bool> emplaceHint(node<Key>* hint, K const& key, Args&&... args);
+        // links in newNode unless its key is present, otherwise destroys it
+        std::pair<node<Key>*, bool> emplaceNode(node<Key>* hint, node<Key>* newNode);
+        // visited holds the head above the levels in use if newNode may top the list
+        // by more than one level
+        void linkNode(node<Key>* newNode, update_path const& visited);
+        // links a node for every key at the back of the empty list, the keys are sorted
+        template <class IterType>
+        void appendSorted(IterType first, IterType last);
+        template <class K>
+        size_type eraseKey(K const& key);
+        // unlinks and destroys nd in O(height) through its prev links; an indexed list
+        // takes O(log n) to fix the widths unless the search path of nd is given
+        void unlinkNode(node<Key>* nd, update_path const* visited = nullptr);
+        // the same, but nd is left alive for another list to link in
+        void detachNode(node<Key>* nd, update_path const* visited = nullptr);
+        // unlinks and destroys the nodes from first up to last (exclusive, nullptr is the end)
+        size_type unlinkRun(node<Key>* first, node<Key>* last);
+
+        typedef typename std::allocator_traits<Allocator>::template rebind_alloc<node_unit<Key>> node_allocator;
+
+        template <class K>
+        skip_list splitAt(K const& key);
+        // links the nodes of right, whose keys are all greater, after the last node
+        // at every level, right is left empty
+        void appendList(skip_list& right);
+
+        void destroyNodes();
+        void resetFinger();
         size_t multiCoin() const;
 
-        mutable RandomGen& mRand;
-        float mProb{ 0.36787944117144f };
-        node_base* mHead{ nullptr };
+        // widths of the links around a node that is about to be linked after visited
+        void linkWidths(node<Key>* newNode, update_path const& visited);
+        // adds delta to the widths of the links passing over nd at level and above,
+        // nd stands at level - 1
+        void passWidths(node<Key>* nd, size_t level, difference_type delta);
+        node<Key>* nthNode(size_type k) const;
+        template <class K>
+        size_type rankOf(K const& key) const;
+
+        // points the link of from at level to to, and copies the key of to beside it if keys are cached
+        void link(node<Key>* from, size_t level, node<Key>* to);
+        // starts loading the node the link of nd at level leads to, if the policy asks for it
+        void prefetchLink(node<Key> const* nd, size_t level) const;
+        // true if the link of nd at level leads to a node less than key,
+        // the node itself is not read if its key is cached
+        template <class K>
+        bool linkBefore(node<Key> const* nd, size_t level, K const& key) const;
+
+        // the slots of the towers besides the next and prev links: widths and cached keys
+        static constexpr std::uint32_t NodeLayout = (Indexed ? node<Key>::width_links : node<Key>::plain_links)
+            | (CachedKeys ? node<Key>::keyed_links : node<Key>::plain_links);
+        // node<Key>::keyShift of the nodes, known to the searches at compile time
+        static constexpr size_t KeyShift = CachedKeys ? 1 : 0;
+
+        node_allocator mAlloc;
+        Compare mComp;
+        RandomGen& mRand;
+        LevelGen mLevelGen;
+        node<Key>* mHead{ nullptr };
+        size_t mLevels{ 1 }; // levels of the head tower in use
         size_type mSize{ 0 };
+        // search path of the last operation in finger mode, levels from mLevels up hold the head
+        mutable update_path mFinger;
+        bool mFingerOn{ false };
     };
 
-    template <class Key, class RandomGen>
-    void swap(skip_list<Key, RandomGen>& lhs, skip_list<Key, RandomGen>& rhs)
+    // skip_list with positional access: nth, index_of, rank, count_range
+    template <class Key, class RandomGen, class Compare = std::less<Key>, class Allocator = std::allocator<Key>, class LevelGen = coin_level>
+    using indexed_skip_list = skip_list<Key, RandomGen, Compare, Allocator, LevelGen, true>;
+
+    // skip_list for small trivially copyable keys that copies the key of every node into the links
+    // pointing at it: a search decides whether to follow a link without touching the node behind it,
+    // each copy sits in the slot right past its link, so both come in one cache line
+    template <class Key, class RandomGen, class Compare = std::less<Key>, class Allocator = std::allocator<Key>, class LevelGen = coin_level>
+    using cached_skip_list = skip_list<Key, RandomGen, Compare, Allocator, LevelGen, false, true>;
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    void swap(skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>& lhs, skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>& rhs)
     {
         lhs.swap(rhs);
     }
@@ -145,8 +462,8 @@ namespace algic
 
 namespace std
 {
-    template <class Key, class RandomGen>
-    void swap(algic::skip_list<Key, RandomGen>& lhs, algic::skip_list<Key, RandomGen>& rhs)
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    void swap(algic::skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>& lhs, algic::skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>& rhs)
     {
         algic::swap(lhs, rhs);
     }
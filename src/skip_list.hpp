@@ -3,9 +3,14 @@
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
 #include <vector>
 
 
@@ -13,179 +18,289 @@ namespace algic
 {
     using std::size_t;
 
+    // node and its tower of links live in a single allocation:
+    // [ node<Key> | next links x height | prev links x height | (widths x height) ]
+    // widths are only there for the nodes of indexed lists (width_links),
+    // a width counts the level 0 steps its link spans, widths of null links are not kept;
+    // lists with cached keys (keyed_links) follow every next link with a copy of the key
+    // it leads to, null links have none:
+    // [ node<Key> | (next link, key) x height | prev links x height | (widths x height) ]
+    // so that a search reads the key in the cache line of the link it compares
+    // the head of a list is a node as well, its key is never constructed nor compared
+    // prev links point back at every level, the first node of a level points to the head;
+    // the head's prev at level 0 is the last node, the others are not used
+    // nodes are allocated by an allocator rebound to node_unit<Key>,
+    // a node of height h takes units(h, layout) of them
     template <class Key>
-    struct node;
-
-
-    struct node_base
+    struct node
     {
-        node_base(size_t height);
-        virtual ~node_base();
+        // what a node keeps per level besides its next and prev links, flags
+        enum link_layout : std::uint32_t { plain_links = 0, width_links = 1, keyed_links = 2 };
+
+        template <class Alloc, class... Args>
+        static node* create(Alloc& alloc, size_t height, std::uint32_t layout, Args&&... args);
+        template <class Alloc>
+        static node* createHead(Alloc& alloc, size_t height, std::uint32_t layout);
+        template <class Alloc>
+        static void destroy(Alloc& alloc, node* nd);
+        template <class Alloc>
+        static void destroyHead(Alloc& alloc, node* nd);
+
+        static size_t units(size_t height, std::uint32_t layout);
+        // log2 of the distance between next links, 1 if keys are cached beside them
+        static size_t keyShift(std::uint32_t layout);
 
         size_t height() const;
-        node_base* next(size_t level) const;
-        void set(size_t level, node_base* nb);
+        node* next(size_t level) const;
+        // the same for a caller that knows the layout of the node, keyShift is keyShift(),
+        // a search then does not wait for the layout to be loaded before every hop
+        node* next(size_t level, size_t keyShift) const;
+        void set(size_t level, node* nd);
+        node* prev(size_t level) const;
+        void setPrev(size_t level, node* nd);
+        size_t width(size_t level) const;
+        void setWidth(size_t level, size_t width);
+        Key const& linkKey(size_t level) const;
+        void setLinkKey(size_t level, Key const& key);
 
-        void incHeight();
-        void decHeight();
-
-        template <class Key>
-        node<Key>* as()
-        {
-            return dynamic_cast<node<Key>*>(this);
-        }
+        Key& value();
+        Key const& value() const;
 
     private:
-        size_t  mHeight;
-        node_base**  mLinks;
+        node(size_t height, std::uint32_t layout);
+
+        node** tower();
+        node* const* tower() const;
+        size_t* widths();
+        size_t const* widths() const;
+        size_t keyShift() const;
+        // pointer-aligned, so that sizeof(node) keeps the tower aligned as well
+        alignas(void*) std::uint32_t  mHeight;
+        std::uint32_t  mLayout;
+        typename std::aligned_storage<sizeof(Key), alignof(Key)>::type  mData;
     };
 
-
     template <class Key>
-    struct node : public node_base
+    struct alignas(node<Key>) node_unit
     {
-        node(size_t height, Key const& key);
-        node(size_t height, Key&& key);
-        ~node();
+        unsigned char  mBytes[alignof(node<Key>)];
+    };
 
-        Key& value();
-        Key const& value() const;
+    // Allocators that own their memory exclusively (see pool_allocator) let a list
+    // drop all of its nodes at once instead of deallocating them one by one
+    template <class Alloc, class = void>
+    struct bulk_release
+    {
+        static bool possible(Alloc const&)
+        {
+            return false;
+        }
 
-    private:
-        Key* asT();
-        Key const* asT() const;
+        static void release(Alloc&)
+        {
+        }
+    };
+
+    template <class Alloc>
+    struct bulk_release<Alloc, decltype(std::declval<Alloc&>().release(), void())>
+    {
+        static bool possible(Alloc const& alloc)
+        {
+            return alloc.exclusive();
+        }
 
-        char mData[sizeof(Key)];
+        static void release(Alloc& alloc)
+        {
+            alloc.release();
+        }
     };
 
+    /**********************************************************/
+    /*                  implementations                       */
+
+    /**********************************************************/
+    /*                         node                           */
     template <class Key>
-    bool less(node_base* node, Key const& val)
+    template <class Alloc, class... Args>
+    node<Key>* node<Key>::create(Alloc& alloc, size_t height, std::uint32_t layout, Args&&... args)
     {
-        if (auto tNode = node->as<Key>())
-            return std::less<Key>()(tNode->value(), val);
-        else
-            return true;
+        node* nd = createHead(alloc, height, layout);
+        try
+        {
+            new (static_cast<void*>(&nd->mData))Key(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            destroyHead(alloc, nd);
+            throw;
+        }
+        return nd;
     }
 
     template <class Key>
-    bool eq(node_base* node, Key const& val)
+    template <class Alloc>
+    node<Key>* node<Key>::createHead(Alloc& alloc, size_t height, std::uint32_t layout)
     {
-        if (auto tNode = node->as<Key>())
-            return std::equal_to<Key>()(tNode->value(), val);
-        else
-            return false;
+        void* mem = std::allocator_traits<Alloc>::allocate(alloc, units(height, layout));
+        return new (mem) node(height, layout);
     }
 
     template <class Key>
-    bool gt(node_base* node, Key const& val)
+    template <class Alloc>
+    void node<Key>::destroy(Alloc& alloc, node* nd)
     {
-        if (auto tNode = node->as<Key>())
-            return std::greater<Key>()(tNode->value(), val);
-        else
-            return false;
+        nd->value().~Key();
+        destroyHead(alloc, nd);
     }
 
+    template <class Key>
+    template <class Alloc>
+    void node<Key>::destroyHead(Alloc& alloc, node* nd)
+    {
+        std::allocator_traits<Alloc>::deallocate(alloc,
+            static_cast<node_unit<Key>*>(static_cast<void*>(nd)), units(nd->mHeight, nd->mLayout));
+    }
 
+    template <class Key>
+    size_t node<Key>::units(size_t height, std::uint32_t layout)
+    {
+        static_assert(sizeof(size_t) == sizeof(node*), "Widths take the place of links");
+        size_t const slots = 2 + ((layout & width_links) ? 1 : 0) + ((layout & keyed_links) ? 1 : 0);
+        size_t const bytes = sizeof(node) + slots * height * sizeof(node*);
+        return (bytes + sizeof(node_unit<Key>) - 1) / sizeof(node_unit<Key>);
+    }
 
-    /**********************************************************/
-    /*                  implementations                       */
+    template <class Key>
+    node<Key>::node(size_t height, std::uint32_t layout)
+        : mHeight(static_cast<std::uint32_t>(height))
+        , mLayout(layout)
+    {
+        // the key slots are cleared along with the links
+        std::fill(tower(), tower() + (mHeight << keyShift()) + mHeight, nullptr);
+        if (mLayout & width_links)
+            std::fill(widths(), widths() + mHeight, 0);
+    }
 
-    /**********************************************************/
-    /*                      node_base                         */
-    node_base::node_base(size_t height)
-        : mHeight(height)
-        , mLinks(new node_base*[mHeight])
+    template <class Key>
+    size_t node<Key>::height() const
     {
-        std::fill(mLinks, mLinks + mHeight, nullptr);
+        return mHeight;
     }
 
-    node_base::~node_base()
+    template <class Key>
+    node<Key>* node<Key>::next(size_t level) const
     {
-        delete [] mLinks;
+        return next(level, keyShift());
     }
 
-    size_t node_base::height() const
+    template <class Key>
+    node<Key>* node<Key>::next(size_t level, size_t keyShift) const
     {
-        return mHeight;
+        assert(level < mHeight && keyShift == this->keyShift() && "Index out of range");
+        return tower()[level << keyShift];
     }
 
-    node_base* node_base::next(size_t level) const
+    template <class Key>
+    void node<Key>::set(size_t level, node* nd)
     {
         assert(level < mHeight && "Index out of range");
-        return mLinks[level];
+        tower()[level << keyShift()] = nd;
     }
 
-    void node_base::set(size_t level, node_base* nb)
+    template <class Key>
+    node<Key>* node<Key>::prev(size_t level) const
     {
         assert(level < mHeight && "Index out of range");
-        mLinks[level] = nb;
+        return tower()[(mHeight << keyShift()) + level];
     }
 
-    void node_base::incHeight()
+    template <class Key>
+    void node<Key>::setPrev(size_t level, node* nd)
     {
-        ++mHeight;
-        node_base** newLinks = new node_base*[mHeight];
-        std::copy(mLinks, mLinks + mHeight, newLinks);
-        delete mLinks;
-        mLinks = newLinks;
-        mLinks[mHeight - 1] = nullptr;
+        assert(level < mHeight && "Index out of range");
+        tower()[(mHeight << keyShift()) + level] = nd;
     }
 
-    void node_base::decHeight()
+    template <class Key>
+    size_t node<Key>::width(size_t level) const
     {
-        assert(mHeight > 0 && "Decreasing zero height is illegal");
-        --mHeight;
-        node_base** newLinks = new node_base*[mHeight];
-        std::copy(mLinks, mLinks + mHeight, newLinks);
-        delete mLinks;
-        mLinks = newLinks;
+        assert(level < mHeight && (mLayout & width_links) && "Index out of range");
+        return widths()[level];
     }
-    
 
-    /**********************************************************/
-    /*                         node                           */
     template <class Key>
-    node<Key>::node(size_t height, Key const& key)
-        : node_base(height)
+    void node<Key>::setWidth(size_t level, size_t width)
     {
-        new (static_cast<void*>(mData))Key(key);
+        assert(level < mHeight && (mLayout & width_links) && "Index out of range");
+        widths()[level] = width;
     }
 
     template <class Key>
-    node<Key>::node(size_t height, Key&& key)
-        : node_base(height)
+    Key const& node<Key>::linkKey(size_t level) const
     {
-        new (static_cast<void*>(mData))Key(std::move(key));
+        assert(level < mHeight && (mLayout & keyed_links) && "Index out of range");
+        // the copy lives in the slot right past the link, set by setLinkKey
+#if defined(__cpp_lib_launder)
+        return *std::launder(reinterpret_cast<Key const*>(tower() + 2 * level + 1));
+#else
+        return *reinterpret_cast<Key const*>(tower() + 2 * level + 1);
+#endif
     }
 
     template <class Key>
-    node<Key>::~node()
+    void node<Key>::setLinkKey(size_t level, Key const& key)
     {
-        static_cast<Key*>(static_cast<void*>(mData))->~Key();
+        assert(level < mHeight && (mLayout & keyed_links) && "Index out of range");
+        new (static_cast<void*>(tower() + 2 * level + 1)) Key(key);
     }
 
     template <class Key>
     Key& node<Key>::value()
     {
-        return static_cast<Key&>(*asT());
+        return *static_cast<Key*>(static_cast<void*>(&mData));
     }
 
     template <class Key>
     Key const& node<Key>::value() const
     {
-        return static_cast<Key const&>(*asT());
+        return *static_cast<Key const*>(static_cast<void const*>(&mData));
+    }
+
+    template <class Key>
+    node<Key>** node<Key>::tower()
+    {
+        // the tower starts right past the node
+        return reinterpret_cast<node**>(this + 1);
+    }
+
+    template <class Key>
+    node<Key>* const* node<Key>::tower() const
+    {
+        return reinterpret_cast<node* const*>(this + 1);
+    }
+
+    template <class Key>
+    size_t* node<Key>::widths()
+    {
+        return reinterpret_cast<size_t*>(tower() + (mHeight << keyShift()) + mHeight);
+    }
+
+    template <class Key>
+    size_t const* node<Key>::widths() const
+    {
+        return reinterpret_cast<size_t const*>(tower() + (mHeight << keyShift()) + mHeight);
     }
 
     template <class Key>
-    Key* node<Key>::asT()
+    size_t node<Key>::keyShift() const
     {
-        return static_cast<Key*>(static_cast<void*>(mData));
+        return keyShift(mLayout);
     }
 
     template <class Key>
-    Key const* node<Key>::asT() const
+    size_t node<Key>::keyShift(std::uint32_t layout)
     {
-        return static_cast<Key const*>(static_cast<void*>(mData));
+        return (layout & keyed_links) >> 1;
     }
 
 
@@ -193,38 +308,43 @@ namespace algic
     /*                 slist_const_iterator                   */
 
     template <class Key>
-    template <class RandomGen>//, class Compare = std::less<Key>, class Allocator = std::allocator<Key>>
-    slist_const_iterator<Key>::slist_const_iterator(skip_list<Key, RandomGen/*, Compare, Allocator*/> const* slist, node_base* node)
-        : mSlist(static_cast<void const*>(slist))
-        , mNode(node)
+    template <class SkipList>
+    slist_const_iterator<Key>::slist_const_iterator(SkipList const* slist, node<Key>* nd)
+        : mHead(slist->mHead)
+        , mNode(nd)
+        , mScanLevels(SkipList::prefetch_policy::scan_levels)
     {
     }
 
     template <class Key>
     slist_const_iterator<Key>::slist_const_iterator(slist_const_iterator const& rhs)
-        : mSlist(rhs.mSlist)
+        : mHead(rhs.mHead)
         , mNode(rhs.mNode)
+        , mScanLevels(rhs.mScanLevels)
     {
     }
 
     template <class Key>
     slist_const_iterator<Key> const& slist_const_iterator<Key>::operator=(slist_const_iterator const& rhs)
     {
-        mSlist = rhs.mSlist;
+        mHead = rhs.mHead;
         mNode = rhs.mNode;
+        mScanLevels = rhs.mScanLevels;
         return *this;
     }
 
     template <class Key>
     Key const& slist_const_iterator<Key>::operator*() const
     {
-        return mNode->as<Key>()->value();
+        return mNode->value();
     }
 
     template <class Key>
     slist_const_iterator<Key>& slist_const_iterator<Key>::operator++()
     {
         mNode = mNode->next(0);
+        if (mScanLevels && mNode)
+            prefetchAhead();
         return *this;
     }
 
@@ -232,388 +352,1587 @@ namespace algic
     slist_const_iterator<Key> slist_const_iterator<Key>::operator++(int)
     {
         auto prevIter = *this;
-        mNode = mNode->next(0);
+        ++*this;
         return prevIter;
     }
 
+    template <class Key>
+    slist_const_iterator<Key>& slist_const_iterator<Key>::operator--()
+    {
+        // end() has no node, the node before it is the last one
+        mNode = mNode ? mNode->prev(0) : mHead->prev(0);
+        return *this;
+    }
+
+    template <class Key>
+    slist_const_iterator<Key> slist_const_iterator<Key>::operator--(int)
+    {
+        auto nextIter = *this;
+        --*this;
+        return nextIter;
+    }
+
     template <class Key>
     bool slist_const_iterator<Key>::operator==(slist_const_iterator const& rhs) const
     {
-        return mSlist == rhs.mSlist && mNode == rhs.mNode;
+        return mHead == rhs.mHead && mNode == rhs.mNode;
     }
 
     template <class Key>
     bool slist_const_iterator<Key>::operator!=(slist_const_iterator const& rhs) const
     {
-        return mSlist != rhs.mSlist || mNode != rhs.mNode;
+        return mHead != rhs.mHead || mNode != rhs.mNode;
     }
 
     template <class Key>
     bool slist_const_iterator<Key>::operator==(slist_iterator<Key> const& rhs) const
     {
-        return mSlist == rhs.mSlist && mNode == rhs.mNode;
+        return mHead == rhs.mHead && mNode == rhs.mNode;
     }
 
     template <class Key>
     bool slist_const_iterator<Key>::operator!=(slist_iterator<Key> const& rhs) const
     {
-        return mSlist != rhs.mSlist || mNode != rhs.mNode;
+        return mHead != rhs.mHead || mNode != rhs.mNode;
+    }
+
+    template <class Key>
+    void slist_const_iterator<Key>::prefetchAhead() const
+    {
+        // the links of a tower reach further the higher they are,
+        // level l points about e^l nodes ahead with prob = 1 / e
+        size_t const levels = std::min(mScanLevels, mNode->height());
+        for (size_t lvl = 0; lvl < levels; ++lvl)
+        {
+            if (node<Key>* ahead = mNode->next(lvl))
+                prefetch_line(ahead);
+        }
     }
 
     template <class Key>
-    template <class RandomGen>//, class Compare = std::less<Key>, class Allocator = std::allocator<Key>>
-    slist_iterator<Key>::slist_iterator(skip_list<Key, RandomGen/*, Compare, Allocator*/> const* slist, node_base* node)
-        : slist_const_iterator(slist, node)
+    template <class SkipList>
+    slist_iterator<Key>::slist_iterator(SkipList const* slist, node<Key>* nd)
+        : slist_const_iterator<Key>(slist, nd)
     {
     }
     
     /**********************************************************/
     /*                      skip_list                         */
 
-    template <class Key, class RandomGen>
-    skip_list<Key, RandomGen>::skip_list(RandomGen& randGen, float prob)
-        : mRand(randGen)
-        , mHead(new node_base(1))
-        , mProb(prob)
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    constexpr size_t skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::MaxHeight;
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    constexpr std::uint32_t skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::NodeLayout;
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    constexpr size_t skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::KeyShift;
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::skip_list(RandomGen& randGen, float prob, Compare const& comp, Allocator const& alloc)
+        : mAlloc(alloc)
+        , mComp(comp)
+        , mRand(randGen)
+        , mLevelGen(prob)
     {
         //assert(prob >= 0.0f && "Probability can'key be negative");
         //assert(prob <= 1.0f && "Probability must be not greater than 1");
         if (prob < 0.0f || prob > 1.0f)
             throw std::invalid_argument("Probabiliry must be in [0, 1] range");
+        mHead = node<Key>::createHead(mAlloc, MaxHeight, NodeLayout);
+        resetFinger();
     }
 
-    template <class Key, class RandomGen>
-    skip_list<Key, RandomGen>::~skip_list()
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::skip_list(skip_list&& rhs)
+        : mAlloc(rhs.mAlloc)
+        , mComp(rhs.mComp)
+        , mRand(rhs.mRand)
+        , mLevelGen(rhs.mLevelGen)
+        , mFinger(rhs.mFinger)
+        , mFingerOn(rhs.mFingerOn)
     {
-        node_base* curNode = mHead;
-        while (mHead)
-        {
-            mHead = mHead->next(0);
-            delete curNode;
-            curNode = mHead;
-        }
+        mHead = node<Key>::createHead(mAlloc, MaxHeight, NodeLayout);
+        std::swap(mHead, rhs.mHead);
+        std::swap(mLevels, rhs.mLevels);
+        std::swap(mSize, rhs.mSize);
+        rhs.resetFinger();
     }
 
-    template <class Key, class RandomGen>
-    typename skip_list<Key, RandomGen>::iterator skip_list<Key, RandomGen>::begin()
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::~skip_list()
+    {
+        destroyNodes();
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::allocator_type skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::get_allocator() const
+    {
+        return allocator_type(mAlloc);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::begin()
     {
         return slist_iterator<Key>(this, mHead->next(0));
     }
 
-    template <class Key, class RandomGen>
-    typename skip_list<Key, RandomGen>::const_iterator skip_list<Key, RandomGen>::begin() const
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::const_iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::begin() const
     {
         return slist_const_iterator<Key>(this, mHead->next(0));
     }
 
-    template <class Key, class RandomGen>
-    typename skip_list<Key, RandomGen>::const_iterator skip_list<Key, RandomGen>::cbegin() const
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::const_iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::cbegin() const
     {
         return slist_const_iterator<Key>(this, mHead->next(0));
     }
 
-    template <class Key, class RandomGen>
-    typename skip_list<Key, RandomGen>::iterator skip_list<Key, RandomGen>::end()
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::end()
     {
         return slist_iterator<Key>(this, nullptr);
     }
 
-    template <class Key, class RandomGen>
-    typename skip_list<Key, RandomGen>::const_iterator skip_list<Key, RandomGen>::end() const
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::const_iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::end() const
     {
         return slist_const_iterator<Key>(this, nullptr);
     }
 
-    template <class Key, class RandomGen>
-    typename skip_list<Key, RandomGen>::const_iterator skip_list<Key, RandomGen>::cend() const
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::const_iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::cend() const
     {
         return slist_const_iterator<Key>(this, nullptr);
     }
 
 
-    template <class Key, class RandomGen>
-    void skip_list<Key, RandomGen>::swap(skip_list& rhs)
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::reverse_iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::rbegin()
+    {
+        return reverse_iterator(end());
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::const_reverse_iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::rbegin() const
+    {
+        return const_reverse_iterator(end());
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::const_reverse_iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::crbegin() const
+    {
+        return const_reverse_iterator(cend());
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::reverse_iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::rend()
+    {
+        return reverse_iterator(begin());
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::const_reverse_iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::rend() const
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::const_reverse_iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::crend() const
+    {
+        return const_reverse_iterator(cbegin());
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    void skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::swap(skip_list& rhs)
     {
-        std::swap(mRand, rhs.mRand);
-        std::swap(mProb, rhs.mProb);
+        std::swap(mAlloc, rhs.mAlloc);
+        std::swap(mComp, rhs.mComp);
+        std::swap(mLevelGen, rhs.mLevelGen);
         std::swap(mHead, rhs.mHead);
+        std::swap(mLevels, rhs.mLevels);
         std::swap(mSize, rhs.mSize);
+        std::swap(mFinger, rhs.mFinger);
+        std::swap(mFingerOn, rhs.mFingerOn);
     }
 
-    template <class Key, class RandomGen>
-    bool skip_list<Key, RandomGen>::empty() const
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    bool skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::empty() const
     {
         return (mHead->next(0) == nullptr);
     }
 
-    template <class Key, class RandomGen>
-    typename skip_list<Key, RandomGen>::size_type skip_list<Key, RandomGen>::size() const
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::size_type skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::size() const
     {
         return mSize;
     }
 
-    template <class Key, class RandomGen>
-    void skip_list<Key, RandomGen>::clear()
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    void skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::clear()
     {
-        node_base* curNode = mHead;
-        while (mHead)
-        {
-            mHead = mHead->next(0);
-            delete curNode;
-            curNode = mHead;
-        }
-        mHead = new node_base(1);
+        destroyNodes();
+        mHead = node<Key>::createHead(mAlloc, MaxHeight, NodeLayout);
+        mLevels = 1;
         mSize = 0;
+        resetFinger();
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::pairib skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::insert(Key const& key)
+    {
+        auto const res = emplaceKey(key, key);
+        return std::make_pair(iterator(this, res.first), res.second);
     }
 
-    template <class Key, class RandomGen>
-    typename skip_list<Key, RandomGen>::pairib skip_list<Key, RandomGen>::insert(Key const& key)
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::pairib skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::insert(Key&& key)
     {
-        return insert(std::move(Key(key)));
+        // the key is only moved into the node once the search is over
+        auto const res = emplaceKey(key, std::move(key));
+        return std::make_pair(iterator(this, res.first), res.second);
     }
 
-    template <class Key, class RandomGen>
-    typename skip_list<Key, RandomGen>::pairib skip_list<Key, RandomGen>::insert(Key&& key)
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class IterType>
+    void skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::insert(IterType first, IterType last)
     {
-        size_t const H = mHead->height();
-        // treat first element in a special way
-        if (H == 1 && !mHead->next(0))
+        for (auto it = first; it != last; ++it)
         {
-            node_base* newNode = new node<Key>(1, std::move(key));
-            mHead->set(0, newNode);
-            ++mSize;
-            return std::make_pair(iterator(this, newNode), true);
+            insert(*it);
         }
+    }
 
-        std::vector<node_base*> visited(H + 1, nullptr);
-        if (visit(key, &visited)) // if already exists
-            return std::make_pair(end(), false);
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    void skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::insert(std::initializer_list<value_type> ilist)
+    {
+        insert(std::cbegin(ilist), std::cend(ilist));
+    }
 
-        // randomly choose the height of the new element
-        size_t const newLvl = multiCoin();
-        node_base* newNode = new node<Key>(newLvl, std::move(key));
-        if (newLvl > H)
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class IterType>
+    void skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::assign_sorted(IterType first, IterType last)
+    {
+        if (std::is_sorted(first, last, mComp))
         {
-            mHead->incHeight();
-            mHead->set(H, newNode);
+            clear();
+            appendSorted(first, last);
+            return;
         }
 
-        // reassign links
-        size_t const minLvl = std::min(newLvl, H);
-        for (size_t i = 0; i < minLvl; ++i)
-        {
-            newNode->set(i, visited[i]->next(i));
-            visited[i]->set(i, newNode);
-        }
-        ++mSize;
-        return std::make_pair(iterator(this, newNode), true);
+        std::vector<Key> keys(first, last);
+        std::sort(std::begin(keys), std::end(keys), mComp);
+        clear();
+        appendSorted(std::make_move_iterator(std::begin(keys)), std::make_move_iterator(std::end(keys)));
     }
 
-    template <class Key, class RandomGen>
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
     template <class IterType>
-    void skip_list<Key, RandomGen>::insert(IterType first, IterType last)
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::size_type skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::insert_batch(IterType first, IterType last)
     {
-        for (auto it = first; it != last; ++it)
+        std::vector<Key> keys(first, last);
+        if (!std::is_sorted(std::begin(keys), std::end(keys), mComp))
+            std::sort(std::begin(keys), std::end(keys), mComp);
+
+        // every key is searched from the path of the previous one
+        size_type const oldSize = mSize;
+        update_path visited;
+        visited.fill(mHead);
+        for (auto& key : keys)
         {
-            insert(*it);
+            node<Key>* foundNode = visitAhead(visited, key)->next(0);
+            if (isEqual(foundNode, key)) // if already exists
+                continue;
+            linkNode(node<Key>::create(mAlloc, multiCoin(), NodeLayout, std::move(key)), visited);
         }
+        // new nodes may have slipped in before the finger
+        if (mFingerOn)
+            resetFinger();
+        return mSize - oldSize;
     }
 
-    template <class Key, class RandomGen>
-    void skip_list<Key, RandomGen>::insert(std::initializer_list<value_type> ilist)
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::insert(const_iterator hint, Key const& key)
     {
-        insert(std::cbegin(ilist), std::cend(ilist));
+        return iterator(this, emplaceHint(hint.mNode, key, key).first);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::insert(const_iterator hint, Key&& key)
+    {
+        return iterator(this, emplaceHint(hint.mNode, key, std::move(key)).first);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class... Args>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::pairib skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::emplace(Args&&... args)
+    {
+        auto const res = emplaceNode(nullptr, node<Key>::create(mAlloc, multiCoin(), NodeLayout, std::forward<Args>(args)...));
+        return std::make_pair(iterator(this, res.first), res.second);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class... Args>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::emplace_hint(const_iterator hint, Args&&... args)
+    {
+        return iterator(this, emplaceNode(hint.mNode, node<Key>::create(mAlloc, multiCoin(), NodeLayout, std::forward<Args>(args)...)).first);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::pairib skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::try_emplace(Key const& key)
+    {
+        return insert(key);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::pairib skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::try_emplace(Key&& key)
+    {
+        return insert(std::move(key));
     }
 
-    template <class Key, class RandomGen>
-    typename skip_list<Key, RandomGen>::iterator skip_list<Key, RandomGen>::erase(iterator pos)
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class K, class C, class>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::pairib skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::try_emplace(K&& key)
+    {
+        // the key is only forwarded into the node once the search is over
+        auto const res = emplaceKey(key, std::forward<K>(key));
+        return std::make_pair(iterator(this, res.first), res.second);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::erase(iterator pos)
     {
         if (pos == end())
             return end();
-        iterator next = pos;
-        ++next;
-        erase(*pos);
-        return next;
+        node<Key>* nextNode = pos.mNode->next(0);
+        unlinkNode(pos.mNode);
+        return iterator(this, nextNode);
     }
 
-    template <class Key, class RandomGen>
-    typename skip_list<Key, RandomGen>::const_iterator skip_list<Key, RandomGen>::erase(const_iterator pos)
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::const_iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::erase(const_iterator pos)
     {
         if (pos == end())
             return cend();
-        const_iterator next = pos;
-        ++next;
-        erase(*pos);
-        return next;
+        node<Key>* nextNode = pos.mNode->next(0);
+        unlinkNode(pos.mNode);
+        return const_iterator(this, nextNode);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::erase(const_iterator first, const_iterator last)
+    {
+        unlinkRun(first.mNode, last.mNode);
+        return iterator(this, last.mNode);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::size_type skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::erase(Key const& key)
+    {
+        return eraseKey(key);
     }
 
-    template <class Key, class RandomGen>
-    typename skip_list<Key, RandomGen>::size_type skip_list<Key, RandomGen>::erase(Key const& key)
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class Pred>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::size_type skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::erase_if(Pred pred)
     {
-        size_t const H = mHead->height();
-        std::vector<node_base*> visited(H, nullptr);
-        if (node_base* foundNode = visit(key, &visited))
+        // keep has the last survivor at every level; a level is only relinked past a run of
+        // erased nodes that stood on it, and a width only changes if the run it spans lost
+        // nodes, so the survivors are written to where a run is spliced out, like unlinkRun
+        update_path keep;
+        std::array<size_type, MaxHeight> positions; // of the nodes of keep, the erased ones left out
+        std::array<size_type, MaxHeight> erasedAt;  // number of nodes erased when keep was set
+        std::array<bool, MaxHeight> relink;         // an erased node stood on the level past keep
+        // where the link of the node erased last on a level led and the position it had,
+        // a throwing pred leaves the list with the levels past keep linked there
+        update_path after;
+        std::array<size_type, MaxHeight> afterAt;
+        keep.fill(mHead);
+        after.fill(nullptr);
+        afterAt.fill(0);
+        positions.fill(0);
+        erasedAt.fill(0);
+        relink.fill(false);
+        size_type pos = 0;
+        size_type count = 0;
+        // the nodes erased before the first survivor are only destroyed once it is found,
+        // a list that loses everything is dropped by clear()
+        node<Key>* front = mHead->next(0);
+        for (node<Key>* curNode = front; curNode;)
         {
-                // reassign links and delete the element
-            size_t const H = mHead->height();
-            for (size_t i = 0; i < H; ++i)
+            node<Key>* nextNode = curNode->next(0);
+            size_t const height = curNode->height();
+            bool erase;
+            try
+            {
+                erase = pred(curNode->value());
+            }
+            catch (...)
+            {
+                // the list is left with the nodes erased so far: curNode and the nodes past it
+                // are untouched, a level that lost nodes past keep is linked to where the node
+                // erased last there led, the others keep their links but span fewer elements
+                for (size_t i = 0; i < mLevels; ++i)
+                {
+                    if (relink[i])
+                    {
+                        link(keep[i], i, after[i]);
+                        if (after[i])
+                        {
+                            after[i]->setPrev(i, keep[i]);
+                            if (Indexed)
+                                keep[i]->setWidth(i, afterAt[i] - count - positions[i]);
+                        }
+                    }
+                    else if (Indexed && erasedAt[i] != count && keep[i]->next(i))
+                        keep[i]->setWidth(i, keep[i]->width(i) + erasedAt[i] - count);
+                }
+                // the nodes erased before the first survivor are still alive
+                while (!pos && front != curNode)
+                {
+                    node<Key>* erased = front;
+                    front = front->next(0);
+                    node<Key>::destroy(mAlloc, erased);
+                }
+                mSize -= count;
+                while (mLevels > 1 && !mHead->next(mLevels - 1))
+                    --mLevels;
+                throw;
+            }
+            if (erase)
+            {
+                size_type const oldPos = pos + count + 1;
+                for (size_t i = 0; i < height; ++i)
+                {
+                    relink[i] = true;
+                    after[i] = curNode->next(i);
+                    if (Indexed && after[i])
+                        afterAt[i] = oldPos + curNode->width(i);
+                    // the finger stays on the path of its key
+                    if (mFinger[i] == curNode)
+                        mFinger[i] = keep[i];
+                }
+                ++count;
+                if (pos)
+                    node<Key>::destroy(mAlloc, curNode);
+            }
+            else
             {
-                if (visited[i] && visited[i]->next(i) == foundNode)
-                    visited[i]->set(i, foundNode->next(i));
+                while (!pos && front != curNode)
+                {
+                    node<Key>* erased = front;
+                    front = front->next(0);
+                    node<Key>::destroy(mAlloc, erased);
+                }
+                ++pos;
+                for (size_t i = 0; i < height; ++i)
+                {
+                    if (erasedAt[i] != count)
+                    {
+                        if (relink[i])
+                        {
+                            link(keep[i], i, curNode);
+                            curNode->setPrev(i, keep[i]);
+                            relink[i] = false;
+                        }
+                        if (Indexed)
+                            keep[i]->setWidth(i, pos - positions[i]);
+                    }
+                    keep[i] = curNode;
+                    positions[i] = pos;
+                    erasedAt[i] = count;
+                }
             }
-            delete foundNode;
-            --mSize;
-            if (!mHead->next(H - 1) && H > 1)
-                mHead->decHeight();
-            return 1;
+            curNode = nextNode;
         }
-        else
+        if (!count)
             return 0;
+        if (!pos)
+        {
+            clear();
+            return count;
+        }
+
+        for (size_t i = 0; i < mLevels; ++i)
+        {
+            if (relink[i])
+                link(keep[i], i, nullptr);
+        }
+        mHead->setPrev(0, keep[0]);
+        mSize -= count;
+        while (mLevels > 1 && !mHead->next(mLevels - 1))
+            --mLevels;
+        return count;
     }
 
-    template <class Key, class RandomGen>
-    typename skip_list<Key, RandomGen>::size_type skip_list<Key, RandomGen>::count(Key const& key)
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::size_type skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::count(Key const& key) const
     {
-        return visit(key) ? 1 : 0;
+        return isEqual(lowerBound(key), key) ? 1 : 0;
     }
 
-    template <class Key, class RandomGen>
-    typename skip_list<Key, RandomGen>::iterator skip_list<Key, RandomGen>::find(Key const& key)
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class K, class C, class>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::size_type skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::count(K const& key) const
     {
-        auto node = visit(key);
-        return iterator(this, node);
+        return isEqual(lowerBound(key), key) ? 1 : 0;
     }
 
-    template <class Key, class RandomGen>
-    typename skip_list<Key, RandomGen>::const_iterator skip_list<Key, RandomGen>::find(Key const& key) const
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::find(Key const& key)
     {
-        auto node = visit(key);
-        return const_iterator(this, node);
+        return iterator(this, findNode(key));
     }
 
-    template <class Key, class RandomGen>
-    typename skip_list<Key, RandomGen>::pairit skip_list<Key, RandomGen>::equal_range(const Key& key)
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class K, class C, class>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::find(K const& key)
     {
-        auto found = visit(key, nullptr, false);
-        if (!found)
-            return std::make_pair(iterator(this, found), iterator(this, found));
+        return iterator(this, findNode(key));
+    }
 
-        auto nextNode = found->next(0);
-        if (less(found, key))
-            return std::make_pair(iterator(this, nextNode), iterator(this, nextNode));
-        else
-            return std::make_pair(iterator(this, found), iterator(this, nextNode));
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::const_iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::find(Key const& key) const
+    {
+        return const_iterator(this, findNode(key));
     }
 
-    template <class Key, class RandomGen>
-    typename skip_list<Key, RandomGen>::paircit skip_list<Key, RandomGen>::equal_range(const Key& key) const
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class K, class C, class>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::const_iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::find(K const& key) const
     {
-        auto found = visit(key, nullptr, false);
-        if (!found)
-            return std::make_pair(const_iterator(this, node), const_iterator(this, node));
+        return const_iterator(this, findNode(key));
+    }
 
-        auto nextNode = found->next(0);
-        if (less(found, key))
-            return std::make_pair(const_iterator(this, nextNode), const_iterator(this, nextNode));
-        else
-            return std::make_pair(const_iterator(this, found), const_iterator(this, nextNode));
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::find(const_iterator hint, Key const& key)
+    {
+        size_t levels;
+        node<Key>* found = visitHint(hint.mNode, key, nullptr, levels)->next(0);
+        return iterator(this, isEqual(found, key) ? found : nullptr);
     }
 
-    template <class Key, class RandomGen>
-    typename skip_list<Key, RandomGen>::iterator skip_list<Key, RandomGen>::lower_bound(const Key& key)
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::const_iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::find(const_iterator hint, Key const& key) const
     {
-        auto found = visit(key, nullptr, false);
-        if (!found || !less(found, key)) // either not found, or found is equal
-            return iterator(this, found);
-        return iterator(this, found->next(0));
+        size_t levels;
+        node<Key>* found = visitHint(hint.mNode, key, nullptr, levels)->next(0);
+        return const_iterator(this, isEqual(found, key) ? found : nullptr);
     }
 
-    template <class Key, class RandomGen>
-    typename skip_list<Key, RandomGen>::const_iterator skip_list<Key, RandomGen>::lower_bound(const Key& key) const
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::pairit skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::equal_range(Key const& key)
     {
-        auto found = visit(key, nullptr, false);
-        if (!found || !less(found, key)) // either not found, or found is equal
-            return const_iterator(this, found);
-        return const_iterator(this, found->next(0));
+        node<Key>* first = lowerBound(key);
+        node<Key>* last = isEqual(first, key) ? first->next(0) : first;
+        return std::make_pair(iterator(this, first), iterator(this, last));
     }
 
-    template <class Key, class RandomGen>
-    typename skip_list<Key, RandomGen>::iterator skip_list<Key, RandomGen>::upper_bound(const Key& key)
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class K, class C, class>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::pairit skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::equal_range(K const& key)
     {
-        auto found = visit(key, nullptr, false);
-        return found ? iterator(this, found->next(0)) : iterator(this, found);
+        node<Key>* first = lowerBound(key);
+        node<Key>* last = isEqual(first, key) ? first->next(0) : first;
+        return std::make_pair(iterator(this, first), iterator(this, last));
     }
 
-    template <class Key, class RandomGen>
-    typename skip_list<Key, RandomGen>::const_iterator skip_list<Key, RandomGen>::upper_bound(const Key& key) const
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::paircit skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::equal_range(Key const& key) const
     {
-        auto found = visit(key, nullptr, false);
-        return found ? const_iterator(this, found->next(0)) : const_iterator(this, found);
+        node<Key>* first = lowerBound(key);
+        node<Key>* last = isEqual(first, key) ? first->next(0) : first;
+        return std::make_pair(const_iterator(this, first), const_iterator(this, last));
     }
 
-    template <class Key, class RandomGen>
-    bool skip_list<Key, RandomGen>::contains(Key const& key)
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class K, class C, class>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::paircit skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::equal_range(K const& key) const
     {
-        return count(key) == 1;
+        node<Key>* first = lowerBound(key);
+        node<Key>* last = isEqual(first, key) ? first->next(0) : first;
+        return std::make_pair(const_iterator(this, first), const_iterator(this, last));
     }
 
-    template <class Key, class RandomGen>
-    node_base* skip_list<Key, RandomGen>::visit(Key const& key, std::vector<node_base*>* visited, bool returnEqOnly) const
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::lower_bound(Key const& key)
     {
-        size_t const H = mHead->height();
-        if (H == 1 && !mHead->next(0))
-            return nullptr;
+        return iterator(this, lowerBound(key));
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class K, class C, class>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::lower_bound(K const& key)
+    {
+        return iterator(this, lowerBound(key));
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::const_iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::lower_bound(Key const& key) const
+    {
+        return const_iterator(this, lowerBound(key));
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class K, class C, class>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::const_iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::lower_bound(K const& key) const
+    {
+        return const_iterator(this, lowerBound(key));
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::upper_bound(Key const& key)
+    {
+        node<Key>* found = lowerBound(key);
+        return iterator(this, isEqual(found, key) ? found->next(0) : found);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class K, class C, class>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::upper_bound(K const& key)
+    {
+        node<Key>* found = lowerBound(key);
+        return iterator(this, isEqual(found, key) ? found->next(0) : found);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::const_iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::upper_bound(Key const& key) const
+    {
+        node<Key>* found = lowerBound(key);
+        return const_iterator(this, isEqual(found, key) ? found->next(0) : found);
+    }
 
-        node_base* foundNode = nullptr;
-        node_base* curNode = mHead;
-        int curLvl = H - 1;
-        bool out = false;
-        while (!out)
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class K, class C, class>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::const_iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::upper_bound(K const& key) const
+    {
+        node<Key>* found = lowerBound(key);
+        return const_iterator(this, isEqual(found, key) ? found->next(0) : found);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    bool skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::contains(Key const& key) const
+    {
+        return findNode(key) != nullptr;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class K, class C, class>
+    bool skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::contains(K const& key) const
+    {
+        return findNode(key) != nullptr;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class IterType, class OutIter>
+    OutIter skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::find_many(IterType first, IterType last, OutIter out)
+    {
+        findNodes(first, last, [this, &out](node<Key>* nd) { *out++ = iterator(this, nd); });
+        return out;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class IterType, class OutIter>
+    OutIter skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::find_many(IterType first, IterType last, OutIter out) const
+    {
+        findNodes(first, last, [this, &out](node<Key>* nd) { *out++ = const_iterator(this, nd); });
+        return out;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class IterType, class OutIter>
+    OutIter skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::contains_many(IterType first, IterType last, OutIter out) const
+    {
+        findNodes(first, last, [&out](node<Key>* nd) { *out++ = nd != nullptr; });
+        return out;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class IterType, class OutIter>
+    OutIter skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::find_sorted(IterType first, IterType last, OutIter out)
+    {
+        findSortedNodes(first, last, [this, &out](node<Key>* nd) { *out++ = iterator(this, nd); });
+        return out;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class IterType, class OutIter>
+    OutIter skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::find_sorted(IterType first, IterType last, OutIter out) const
+    {
+        findSortedNodes(first, last, [this, &out](node<Key>* nd) { *out++ = const_iterator(this, nd); });
+        return out;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class OutIter>
+    OutIter skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::set_union(skip_list const& rhs, OutIter out) const
+    {
+        node<Key>* lhsNode = mHead->next(0);
+        node<Key>* rhsNode = rhs.mHead->next(0);
+        while (lhsNode && rhsNode)
         {
-            auto nextNode = curNode->next(curLvl);
-            if (nextNode && less(nextNode, key))
+            if (mComp(rhsNode->value(), lhsNode->value()))
             {
-                curNode = nextNode;
+                *out++ = rhsNode->value();
+                rhsNode = rhsNode->next(0);
                 continue;
             }
-            else if (curLvl >= 0)
-            {
-                if (visited)
-                    (*visited)[curLvl] = curNode;
-                --curLvl;
-                if (curLvl < 0)
-                {
-                    if (nextNode && eq(nextNode, key))
-                        return nextNode;
-                    else if (returnEqOnly)
-                        return nullptr;
-                    return curNode;
-                }
-            }
+            if (!mComp(lhsNode->value(), rhsNode->value()))
+                rhsNode = rhsNode->next(0);
+            *out++ = lhsNode->value();
+            lhsNode = lhsNode->next(0);
         }
-        assert(false && "This statement should not be reached");
-        return nullptr;
+        for (; lhsNode; lhsNode = lhsNode->next(0))
+            *out++ = lhsNode->value();
+        for (; rhsNode; rhsNode = rhsNode->next(0))
+            *out++ = rhsNode->value();
+        return out;
     }
 
-    template <class Key, class RandomGen>
-    bool skip_list<Key, RandomGen>::coin() const
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class OutIter>
+    OutIter skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::set_intersection(skip_list const& rhs, OutIter out) const
     {
-        return mRand() < mProb;
-    }
-
-    template <class Key, class RandomGen>
-    size_t skip_list<Key, RandomGen>::multiCoin() const
+        bool const lhsSmaller = mSize <= rhs.mSize;
+        skip_list const& smaller = lhsSmaller ? *this : rhs;
+        skip_list const& larger = lhsSmaller ? rhs : *this;
+        update_path path;
+        path.fill(larger.mHead);
+        for (node<Key>* curNode = smaller.mHead->next(0); curNode; curNode = curNode->next(0))
+        {
+            node<Key>* found = larger.visitAhead(path, curNode->value())->next(0);
+            if (!found) // the rest of smaller is past the end of larger
+                break;
+            if (larger.isEqual(found, curNode->value()))
+                *out++ = (lhsSmaller ? curNode : found)->value();
+        }
+        return out;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class OutIter>
+    OutIter skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::set_difference(skip_list const& rhs, OutIter out) const
     {
-        size_t const maxH{ mHead->height() + 1 };
-        size_t count{ 1 };
-        while (mRand() < mProb)
+        update_path path;
+        path.fill(rhs.mHead);
+        node<Key>* curNode = mHead->next(0);
+        for (; curNode; curNode = curNode->next(0))
         {
-            ++count;
-            if (count == maxH)
+            node<Key>* found = rhs.visitAhead(path, curNode->value())->next(0);
+            if (!found) // the rest is past the end of rhs
                 break;
+            if (!rhs.isEqual(found, curNode->value()))
+                *out++ = curNode->value();
+        }
+        for (; curNode; curNode = curNode->next(0))
+            *out++ = curNode->value();
+        return out;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    void skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::merge(skip_list& source)
+    {
+        if (&source == this)
+            return;
+        // nodes may only change lists if this allocator can free them
+        if (!(mAlloc == source.mAlloc))
+        {
+            for (auto it = source.begin(); it != source.end();)
+            {
+                if (insert(*it).second)
+                    it = source.erase(it);
+                else
+                    ++it;
+            }
+            return;
+        }
+
+        update_path visited;
+        visited.fill(mHead);
+        for (node<Key>* curNode = source.mHead->next(0); curNode;)
+        {
+            node<Key>* nextNode = curNode->next(0);
+            if (!isEqual(visitAhead(visited, curNode->value())->next(0), curNode->value()))
+            {
+                // the node keeps its tower, which may top this list by several levels
+                source.detachNode(curNode);
+                linkNode(curNode, visited);
+                for (size_t i = 0; i < curNode->height(); ++i)
+                    visited[i] = curNode;
+            }
+            curNode = nextNode;
+        }
+        // new nodes may have slipped in before the finger
+        if (mFingerOn)
+            resetFinger();
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch> skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::split(Key const& key)
+    {
+        return splitAt(key);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class K, class C, class>
+    skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch> skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::split(K const& key)
+    {
+        return splitAt(key);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    void skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::join(skip_list& other)
+    {
+        if (&other == this || other.empty())
+            return;
+        bool const before = empty() || mComp(mHead->prev(0)->value(), other.mHead->next(0)->value());
+        if (!before && !mComp(other.mHead->prev(0)->value(), mHead->next(0)->value()))
+            throw std::invalid_argument("The keys of the lists to join overlap");
+
+        // nodes may only change lists if this allocator can free them
+        if (!(mAlloc == other.mAlloc))
+        {
+            insert_batch(other.cbegin(), other.cend());
+            other.clear();
+            return;
+        }
+
+        if (before)
+        {
+            appendList(other);
+            return;
+        }
+        // this list goes after other, the nodes are then handed back through the heads
+        other.appendList(*this);
+        std::swap(mHead, other.mHead);
+        std::swap(mLevels, other.mLevels);
+        std::swap(mSize, other.mSize);
+        resetFinger();
+        other.resetFinger();
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::key_compare skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::key_comp() const
+    {
+        return mComp;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::value_compare skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::value_comp() const
+    {
+        return mComp;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    void skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::finger_search(bool enable)
+    {
+        // the finger is not kept up to date while the mode is off
+        if (enable && !mFingerOn)
+            resetFinger();
+        mFingerOn = enable;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    bool skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::finger_search() const
+    {
+        return mFingerOn;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::nth(size_type k)
+    {
+        return iterator(this, nthNode(k));
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::const_iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::nth(size_type k) const
+    {
+        return const_iterator(this, nthNode(k));
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::size_type skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::index_of(const_iterator pos) const
+    {
+        static_assert(Indexed, "Positional access needs an indexed list");
+        if (!pos.mNode)
+            return mSize;
+        // go back along the top links of the towers met, adding up what they span
+        size_type index = 0;
+        for (node<Key>* curNode = pos.mNode; curNode != mHead;)
+        {
+            size_t const top = curNode->height() - 1;
+            curNode = curNode->prev(top);
+            index += curNode->width(top);
+        }
+        return index - 1;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::size_type skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::rank(Key const& key) const
+    {
+        return rankOf(key);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class K, class C, class>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::size_type skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::rank(K const& key) const
+    {
+        return rankOf(key);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::size_type skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::count_range(Key const& lo, Key const& hi) const
+    {
+        return mComp(lo, hi) ? rankOf(hi) - rankOf(lo) : 0;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::iterator skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::advance(const_iterator pos, difference_type n)
+    {
+        return nth(index_of(pos) + n);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::difference_type skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::distance(const_iterator first, const_iterator last) const
+    {
+        return difference_type(index_of(last)) - difference_type(index_of(first));
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class K>
+    node<Key>* skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::visit(K const& key, update_path* visited) const
+    {
+        if (!mFingerOn)
+            return visitFrom(mHead, mLevels, key, visited);
+
+        node<Key>* found = visitFinger(key);
+        if (visited)
+            std::copy(std::begin(mFinger), std::begin(mFinger) + mLevels, std::begin(*visited));
+        return found;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class K>
+    node<Key>* skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::visitFrom(node<Key>* start, size_t levels, K const& key, update_path* visited) const
+    {
+        node<Key>* curNode = start;
+        for (size_t lvl = levels; lvl-- > 0;)
+        {
+            // the node the search drops to from curNode is on its way while the link at lvl is compared
+            for (;;)
+            {
+                if (lvl)
+                    prefetchLink(curNode, lvl - 1);
+                if (!linkBefore(curNode, lvl, key))
+                    break;
+                curNode = curNode->next(lvl, KeyShift);
+            }
+            if (visited)
+                (*visited)[lvl] = curNode;
+        }
+        return curNode;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class K>
+    node<Key>* skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::visitFinger(K const& key) const
+    {
+        // climb to the lowest level where the finger still precedes key with its link not
+        // before key, every level above is then right as well, keys d elements away are
+        // found about log(d) levels up whichever side of the finger they are
+        for (size_t lvl = 0; lvl < mLevels; ++lvl)
+        {
+            node<Key>* curNode = mFinger[lvl];
+            if ((curNode == mHead || mComp(curNode->value(), key)) && !linkBefore(curNode, lvl, key))
+                return visitFrom(curNode, lvl + 1, key, &mFinger);
+        }
+        return visitFrom(mHead, mLevels, key, &mFinger);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class K>
+    node<Key>* skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::visitAhead(update_path& path, K const& key) const
+    {
+        // every node of path is before key, the lowest level whose link is not before key
+        // is right and so are the levels above it
+        size_t lvl = 0;
+        while (lvl + 1 < mLevels && linkBefore(path[lvl], lvl, key))
+            ++lvl;
+        return visitFrom(path[lvl], lvl + 1, key, &path);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class K>
+    node<Key>* skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::visitHint(node<Key>* hint, K const& key, update_path* visited, size_t& levels) const
+    {
+        // widths need the whole path, so indexed lists always search from the head
+        if (Indexed || mFingerOn || !hint || !mComp(hint->value(), key))
+        {
+            levels = mLevels;
+            return visit(key, visited);
+        }
+
+        // go forward along the top links of the towers met while they stay before key,
+        // this climbs about log(d) levels for a key d elements away
+        node<Key>* curNode = hint;
+        while (linkBefore(curNode, curNode->height() - 1, key))
+            curNode = curNode->next(curNode->height() - 1, KeyShift);
+        levels = curNode->height();
+        return visitFrom(curNode, levels, key, visited);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class K>
+    node<Key>* skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::lowerBound(K const& key) const
+    {
+        return visit(key)->next(0);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class K>
+    node<Key>* skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::findNode(K const& key) const
+    {
+        node<Key>* found = lowerBound(key);
+        return isEqual(found, key) ? found : nullptr;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class IterType, class Found>
+    void skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::findNodes(IterType first, IterType last, Found found) const
+    {
+        typedef typename std::iterator_traits<IterType>::value_type K;
+        // a search of the batch: curNode is before key at level lvl, nextNode is its link there
+        struct probe
+        {
+            K const* key;
+            node<Key>* curNode;
+            node<Key>* nextNode;
+            size_t lvl;
+            bool done;
+        };
+
+        // the finger has to move from key to key
+        if (mFingerOn)
+        {
+            for (; first != last; ++first)
+                found(findNode(*first));
+            return;
+        }
+
+        std::array<probe, FindBatch> probes;
+        while (first != last)
+        {
+            size_t count = 0;
+            for (; count < FindBatch && first != last; ++count, ++first)
+            {
+                probe& pr = probes[count];
+                pr.key = std::addressof(*first);
+                pr.curNode = mHead;
+                pr.lvl = mLevels - 1;
+                pr.nextNode = mHead->next(pr.lvl, KeyShift);
+                pr.done = false;
+            }
+
+            // a step reads the node one search prefetched a round ago and prefetches the next
+            // one, by the time the round gets back to a search its node is (nearly) there
+            for (size_t active = count; active;)
+            {
+                active = 0;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    probe& pr = probes[i];
+                    if (pr.done)
+                        continue;
+                    if (pr.nextNode && mComp(CachedKeys ? pr.curNode->linkKey(pr.lvl) : pr.nextNode->value(), *pr.key))
+                        pr.curNode = pr.nextNode;
+                    else if (pr.lvl)
+                        --pr.lvl;
+                    else
+                    {
+                        pr.done = true;
+                        continue;
+                    }
+                    pr.nextNode = pr.curNode->next(pr.lvl, KeyShift);
+                    if (pr.nextNode)
+                        prefetch_line(pr.nextNode);
+                    ++active;
+                }
+            }
+
+            for (size_t i = 0; i < count; ++i)
+                found(isEqual(probes[i].nextNode, *probes[i].key) ? probes[i].nextNode : nullptr);
+        }
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class IterType, class Found>
+    void skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::findSortedNodes(IterType first, IterType last, Found found) const
+    {
+        update_path path;
+        path.fill(mHead);
+        for (IterType prevKey = first; first != last; prevKey = first++)
+        {
+            // the path of a greater key is of no use, start over
+            if (mComp(*first, *prevKey))
+                path.fill(mHead);
+            node<Key>* foundNode = visitAhead(path, *first)->next(0);
+            found(isEqual(foundNode, *first) ? foundNode : nullptr);
+        }
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class K>
+    bool skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::isEqual(node<Key> const* nd, K const& key) const
+    {
+        return nd && !mComp(key, nd->value());
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class K, class... Args>
+    std::pair<node<Key>*, bool> skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::emplaceKey(K const& key, Args&&... args)
+    {
+        return emplaceHint(nullptr, key, std::forward<Args>(args)...);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class K, class... Args>
+    std::pair<node<Key>*, bool> skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::emplaceHint(node<Key>* hint, K const& key, Args&&... args)
+    {
+        update_path visited;
+        size_t levels;
+        node<Key>* foundNode = visitHint(hint, key, &visited, levels)->next(0);
+        if (isEqual(foundNode, key)) // if already exists
+            return std::make_pair(foundNode, false);
+
+        // randomly choose the height of the new element
+        node<Key>* newNode = node<Key>::create(mAlloc, multiCoin(), NodeLayout, std::forward<Args>(args)...);
+        if (std::min(newNode->height(), mLevels) > levels) // the hint is too low for the tower
+            visit(key, &visited);
+        linkNode(newNode, visited);
+        return std::make_pair(newNode, true);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    std::pair<node<Key>*, bool> skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::emplaceNode(node<Key>* hint, node<Key>* newNode)
+    {
+        update_path visited;
+        size_t levels;
+        node<Key>* foundNode = visitHint(hint, newNode->value(), &visited, levels)->next(0);
+        if (isEqual(foundNode, newNode->value())) // if already exists
+        {
+            node<Key>::destroy(mAlloc, newNode);
+            return std::make_pair(foundNode, false);
+        }
+        if (std::min(newNode->height(), mLevels) > levels) // the hint is too low for the tower
+            visit(newNode->value(), &visited);
+        linkNode(newNode, visited);
+        return std::make_pair(newNode, true);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    void skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::linkNode(node<Key>* newNode, update_path const& visited)
+    {
+        if (Indexed)
+            linkWidths(newNode, visited);
+
+        // reassign links
+        size_t const H = mLevels;
+        size_t const newLvl = newNode->height();
+        size_t const minLvl = std::min(newLvl, H);
+        for (size_t i = 0; i < minLvl; ++i)
+        {
+            node<Key>* nextNode = visited[i]->next(i);
+            link(newNode, i, nextNode);
+            newNode->setPrev(i, visited[i]);
+            link(visited[i], i, newNode);
+            if (nextNode)
+                nextNode->setPrev(i, newNode);
+        }
+        if (!newNode->next(0))
+            mHead->setPrev(0, newNode);
+        for (size_t i = H; i < newLvl; ++i)
+        {
+            link(newNode, i, nullptr);
+            newNode->setPrev(i, mHead);
+            link(mHead, i, newNode);
+        }
+        mLevels = std::max(H, newLvl);
+        ++mSize;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class IterType>
+    void skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::appendSorted(IterType first, IterType last)
+    {
+        // the last node at every level, each new node goes right after them
+        update_path tail;
+        tail.fill(mHead);
+        for (; first != last; ++first)
+        {
+            if (tail[0] != mHead && !mComp(tail[0]->value(), *first)) // equal to the previous one
+                continue;
+            node<Key>* newNode = node<Key>::create(mAlloc, multiCoin(), NodeLayout, *first);
+            linkNode(newNode, tail);
+            for (size_t i = 0; i < newNode->height(); ++i)
+                tail[i] = newNode;
         }
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class K>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::size_type skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::eraseKey(K const& key)
+    {
+        // widths above the node are fixed through the path, the other links through prev
+        update_path visited;
+        update_path* const path = Indexed ? &visited : nullptr;
+        node<Key>* foundNode = visit(key, path)->next(0);
+        if (!isEqual(foundNode, key))
+            return 0;
+        unlinkNode(foundNode, path);
+        return 1;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    void skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::unlinkNode(node<Key>* nd, update_path const* visited)
+    {
+        detachNode(nd, visited);
+        node<Key>::destroy(mAlloc, nd);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    void skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::detachNode(node<Key>* nd, update_path const* visited)
+    {
+        if (Indexed)
+        {
+            for (size_t i = 0; i < nd->height(); ++i)
+            {
+                if (nd->next(i))
+                    nd->prev(i)->setWidth(i, nd->prev(i)->width(i) + nd->width(i) - 1);
+            }
+            if (visited)
+            {
+                for (size_t i = nd->height(); i < mLevels; ++i)
+                {
+                    if ((*visited)[i]->next(i))
+                        (*visited)[i]->setWidth(i, (*visited)[i]->width(i) - 1);
+                }
+            }
+            else
+                passWidths(nd->prev(nd->height() - 1), nd->height(), -1);
+        }
+
+        // the neighbours at every level are known, no search is needed
+        for (size_t i = 0; i < nd->height(); ++i)
+        {
+            node<Key>* prevNode = nd->prev(i);
+            node<Key>* nextNode = nd->next(i);
+            link(prevNode, i, nextNode);
+            if (nextNode)
+                nextNode->setPrev(i, prevNode);
+            // the finger stays on the path of its key
+            if (mFinger[i] == nd)
+                mFinger[i] = prevNode;
+        }
+        if (!nd->next(0))
+            mHead->setPrev(0, nd->prev(0));
+        --mSize;
+        while (mLevels > 1 && !mHead->next(mLevels - 1))
+            --mLevels;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::size_type skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::unlinkRun(node<Key>* first, node<Key>* last)
+    {
+        if (first == last)
+            return 0;
+        if (first == mHead->next(0) && !last) // everything goes, allocators may drop it at once
+        {
+            size_type const count = mSize;
+            clear();
+            return count;
+        }
+
+        // the first node of the run standing at a level knows the node before the run there,
+        // the last one knows the node after it
+        update_path before;
+        update_path after;
+        std::array<size_t, MaxHeight> spans; // widths of the run's links at every level
+        size_t height = 0;
+        size_type count = 0;
+        for (node<Key>* curNode = first; curNode != last; ++count)
+        {
+            for (size_t i = 0; i < curNode->height(); ++i)
+            {
+                if (i >= height)
+                {
+                    before[i] = curNode->prev(i);
+                    spans[i] = Indexed ? before[i]->width(i) : 0;
+                }
+                after[i] = curNode->next(i);
+                if (Indexed && after[i])
+                    spans[i] += curNode->width(i);
+                // the finger stays on the path of its key
+                if (mFinger[i] == curNode)
+                    mFinger[i] = before[i];
+            }
+            height = std::max(height, curNode->height());
+            node<Key>* nextNode = curNode->next(0);
+            node<Key>::destroy(mAlloc, curNode);
+            curNode = nextNode;
+        }
+
+        for (size_t i = 0; i < height; ++i)
+        {
+            link(before[i], i, after[i]);
+            if (after[i])
+                after[i]->setPrev(i, before[i]);
+            if (Indexed && after[i])
+                before[i]->setWidth(i, spans[i] - count);
+        }
+        if (Indexed)
+            passWidths(before[height - 1], height, -difference_type(count));
+        if (!last)
+            mHead->setPrev(0, before[0]);
+        mSize -= count;
+        while (mLevels > 1 && !mHead->next(mLevels - 1))
+            --mLevels;
         return count;
     }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class K>
+    skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch> skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::splitAt(K const& key)
+    {
+        static_assert(Indexed, "Only an indexed list knows the sizes of the pieces it is split into");
+        skip_list right(mRand, mLevelGen.prob(), mComp, allocator_type(mAlloc));
+        right.mLevelGen = mLevelGen;
+        right.mFingerOn = mFingerOn;
+
+        // the search path of key with the positions of its nodes, the last one is the size of the left piece
+        update_path path;
+        path.fill(mHead);
+        std::array<size_type, MaxHeight> positions;
+        node<Key>* curNode = mHead;
+        size_type pos = 0;
+        for (size_t lvl = mLevels; lvl-- > 0;)
+        {
+            while (linkBefore(curNode, lvl, key))
+            {
+                pos += curNode->width(lvl);
+                curNode = curNode->next(lvl);
+            }
+            path[lvl] = curNode;
+            positions[lvl] = pos;
+        }
+        if (!path[0]->next(0))
+            return right;
+
+        size_type const leftSize = pos;
+        // the links leaving the path go to the head of right, there are no nodes past
+        // the key at the levels above the first empty one
+        for (size_t i = 0; i < mLevels && path[i]->next(i); ++i)
+        {
+            node<Key>* nextNode = path[i]->next(i);
+            right.mHead->setWidth(i, positions[i] + path[i]->width(i) - leftSize);
+            right.link(right.mHead, i, nextNode);
+            nextNode->setPrev(i, right.mHead);
+            link(path[i], i, nullptr);
+            right.mLevels = i + 1;
+        }
+        right.mHead->setPrev(0, mHead->prev(0));
+        mHead->setPrev(0, path[0]);
+        right.mSize = mSize - leftSize;
+        mSize = leftSize;
+        while (mLevels > 1 && !mHead->next(mLevels - 1))
+            --mLevels;
+        resetFinger();
+        return right;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    void skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::appendList(skip_list& right)
+    {
+        // the last node at every level is found climbing back from the last one, together
+        // with its position if the list is indexed
+        size_t const levels = std::max(mLevels, right.mLevels);
+        update_path tail;
+        std::array<size_type, MaxHeight> positions;
+        node<Key>* curNode = mSize ? mHead->prev(0) : mHead;
+        size_type pos = mSize;
+        for (size_t i = 0; i < levels; ++i)
+        {
+            while (curNode->height() <= i)
+            {
+                curNode = curNode->prev(i - 1);
+                if (Indexed)
+                    pos -= curNode->width(i - 1);
+            }
+            tail[i] = curNode;
+            positions[i] = pos;
+        }
+
+        for (size_t i = 0; i < right.mLevels; ++i)
+        {
+            node<Key>* first = right.mHead->next(i);
+            if (Indexed)
+                tail[i]->setWidth(i, mSize - positions[i] + right.mHead->width(i));
+            link(tail[i], i, first);
+            first->setPrev(i, tail[i]);
+            right.link(right.mHead, i, nullptr);
+        }
+        mHead->setPrev(0, right.mHead->prev(0));
+        right.mHead->setPrev(0, right.mHead);
+        mLevels = levels;
+        mSize += right.mSize;
+        right.mLevels = 1;
+        right.mSize = 0;
+        resetFinger();
+        right.resetFinger();
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    void skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::destroyNodes()
+    {
+        // destroys the head too, with an exclusive pool the slabs go away at once
+        // and nodes of trivially destructible keys are not even visited
+        bool const bulk = bulk_release<node_allocator>::possible(mAlloc);
+        if (!bulk || !std::is_trivially_destructible<Key>::value)
+        {
+            node<Key>* curNode = mHead->next(0);
+            while (curNode)
+            {
+                node<Key>* nextNode = curNode->next(0);
+                if (bulk)
+                    curNode->value().~Key();
+                else
+                    node<Key>::destroy(mAlloc, curNode);
+                curNode = nextNode;
+            }
+        }
+        if (bulk)
+            bulk_release<node_allocator>::release(mAlloc);
+        else
+            node<Key>::destroyHead(mAlloc, mHead);
+        mHead = nullptr;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    void skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::resetFinger()
+    {
+        mFinger.fill(mHead);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    size_t skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::multiCoin() const
+    {
+        // a new node may top the list by one level at most
+        return mLevelGen(mRand, std::min(mLevels + 1, MaxHeight));
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    void skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::linkWidths(node<Key>* newNode, update_path const& visited)
+    {
+        // the distance from the node before at level i to the new node is the one at level i - 1
+        // plus the walk from there at level i - 1, that walk was just searched and is still hot
+        size_t const H = mLevels;
+        size_t distance = 1;
+        for (size_t i = 0; i < newNode->height(); ++i)
+        {
+            node<Key>* prevNode = i < H ? visited[i] : mHead;
+            if (i > 0)
+            {
+                for (node<Key>* curNode = prevNode; curNode != visited[i - 1]; curNode = curNode->next(i - 1))
+                    distance += curNode->width(i - 1);
+            }
+            if (i < H && prevNode->next(i))
+                newNode->setWidth(i, prevNode->width(i) + 1 - distance);
+            prevNode->setWidth(i, distance);
+        }
+        for (size_t i = newNode->height(); i < H; ++i)
+        {
+            if (visited[i]->next(i))
+                visited[i]->setWidth(i, visited[i]->width(i) + 1);
+        }
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    void skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::passWidths(node<Key>* nd, size_t level, difference_type delta)
+    {
+        // the link passing over at a level starts at the last node before that is high enough
+        for (size_t i = level; i < mLevels; ++i)
+        {
+            while (nd->height() <= i)
+                nd = nd->prev(i - 1);
+            if (nd->next(i))
+                nd->setWidth(i, nd->width(i) + delta);
+        }
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    node<Key>* skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::nthNode(size_type k) const
+    {
+        static_assert(Indexed, "Positional access needs an indexed list");
+        if (k >= mSize)
+            return nullptr;
+        // the head is at position 0, the element k at k + 1
+        node<Key>* curNode = mHead;
+        size_type pos = 0;
+        for (size_t lvl = mLevels; lvl-- > 0;)
+        {
+            node<Key>* nextNode = curNode->next(lvl);
+            while (nextNode && pos + curNode->width(lvl) <= k + 1)
+            {
+                pos += curNode->width(lvl);
+                curNode = nextNode;
+                nextNode = curNode->next(lvl);
+            }
+        }
+        return curNode;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class K>
+    typename skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::size_type skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::rankOf(K const& key) const
+    {
+        static_assert(Indexed, "Positional access needs an indexed list");
+        node<Key>* curNode = mHead;
+        size_type pos = 0;
+        for (size_t lvl = mLevels; lvl-- > 0;)
+        {
+            while (linkBefore(curNode, lvl, key))
+            {
+                pos += curNode->width(lvl);
+                curNode = curNode->next(lvl);
+            }
+        }
+        return pos;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    void skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::link(node<Key>* from, size_t level, node<Key>* to)
+    {
+        from->set(level, to);
+        if (CachedKeys && to)
+            from->setLinkKey(level, to->value());
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    template <class K>
+    bool skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::linkBefore(node<Key> const* nd, size_t level, K const& key) const
+    {
+        node<Key> const* nextNode = nd->next(level, KeyShift);
+        return nextNode && mComp(CachedKeys ? nd->linkKey(level) : nextNode->value(), key);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, bool Indexed, bool CachedKeys, class Prefetch>
+    void skip_list<Key, RandomGen, Compare, Allocator, LevelGen, Indexed, CachedKeys, Prefetch>::prefetchLink(node<Key> const* nd, size_t level) const
+    {
+        if (!Prefetch::search)
+            return;
+        if (node<Key> const* nextNode = nd->next(level, KeyShift))
+            prefetch_line(nextNode);
+    }
 } // namespace algic
 
 #endif
@@ -0,0 +1,205 @@
+#ifndef ALGORITHMIC_SKIP_MAP_H
+#define ALGORITHMIC_SKIP_MAP_H
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include "skip_list.h"
+
+
+namespace algic
+{
+    template <class Key, class T, class RandomGen, class Compare = std::less<Key>,
+        class Allocator = std::allocator<std::pair<Key const, T>>, class LevelGen = coin_level>
+    struct skip_map;
+
+    template <class Key, class T>
+    struct smap_const_iterator
+    {
+        typedef std::bidirectional_iterator_tag  iterator_category;
+        typedef std::pair<Key const, T>  value_type;
+        typedef std::ptrdiff_t  difference_type;
+        typedef value_type const*  pointer;
+        typedef value_type const&  reference;
+
+        template <class SkipMap>
+        smap_const_iterator(SkipMap const* smap, node<value_type>* nd);
+
+        value_type const& operator*() const;
+        value_type const* operator->() const;
+
+        smap_const_iterator& operator++();
+        smap_const_iterator operator++(int);
+
+        smap_const_iterator& operator--();
+        smap_const_iterator operator--(int);
+
+        bool operator==(smap_const_iterator const& rhs) const;
+        bool operator!=(smap_const_iterator const& rhs) const;
+
+    protected:
+        template <class, class, class, class, class, class>
+        friend struct skip_map;
+
+        node<value_type>* mHead;
+        node<value_type>* mNode;
+    };
+
+    template <class Key, class T>
+    struct smap_iterator : public smap_const_iterator<Key, T>
+    {
+        typedef std::pair<Key const, T>  value_type;
+        typedef value_type*  pointer;
+        typedef value_type&  reference;
+
+        template <class SkipMap>
+        smap_iterator(SkipMap const* smap, node<value_type>* nd);
+
+        value_type& operator*() const;
+        value_type* operator->() const;
+
+        smap_iterator& operator++();
+        smap_iterator operator++(int);
+
+        smap_iterator& operator--();
+        smap_iterator operator--(int);
+    };
+
+    // orders the elements of a skip_map by their keys, compares keys with elements too
+    template <class Key, class T, class Compare>
+    struct smap_compare
+    {
+        typedef std::pair<Key const, T>  value_type;
+
+        explicit smap_compare(Compare const& comp);
+
+        bool operator()(value_type const& lhs, value_type const& rhs) const;
+        bool operator()(value_type const& lhs, Key const& rhs) const;
+        bool operator()(Key const& lhs, value_type const& rhs) const;
+
+        Compare  mComp;
+    };
+
+
+    /**********************************************************/
+    /*                      skip_map                          */
+    // ordered key/value map on the skip_list engine, values are built inside the nodes
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    struct skip_map
+    {
+        typedef Key key_type;
+        typedef T mapped_type;
+        typedef std::pair<Key const, T> value_type;
+        typedef std::size_t  size_type;
+        typedef Compare key_compare;
+        typedef Allocator allocator_type;
+        typedef value_type& reference;
+        typedef value_type const& const_reference;
+        typedef smap_iterator<Key, T> iterator;
+        typedef smap_const_iterator<Key, T> const_iterator;
+        typedef std::pair<iterator, bool> pairib;
+        typedef std::pair<iterator, iterator>  pairit;
+        typedef std::pair<const_iterator, const_iterator>  paircit;
+        typedef std::reverse_iterator<iterator> reverse_iterator;
+        typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+        skip_map(RandomGen& randGen, float prob = 0.36787944117144f /* prob = 1 / e */,
+            Compare const& comp = Compare(), Allocator const& alloc = Allocator());
+
+        allocator_type get_allocator() const;
+
+        iterator begin();
+        const_iterator begin() const;
+        const_iterator cbegin() const;
+
+        iterator end();
+        const_iterator end() const;
+        const_iterator cend() const;
+
+        reverse_iterator rbegin();
+        const_reverse_iterator rbegin() const;
+        const_reverse_iterator crbegin() const;
+
+        reverse_iterator rend();
+        const_reverse_iterator rend() const;
+        const_reverse_iterator crend() const;
+
+        void swap(skip_map& rhs);
+
+        bool empty() const;
+
+        size_type size() const;
+
+        void clear();
+
+        T& operator[](Key const& key);
+        T& operator[](Key&& key);
+
+        T& at(Key const& key);
+        T const& at(Key const& key) const;
+
+        pairib insert(value_type const& value);
+        pairib insert(value_type&& value);
+
+        template <class... Args>
+        pairib try_emplace(Key const& key, Args&&... args);
+        template <class... Args>
+        pairib try_emplace(Key&& key, Args&&... args);
+
+        template <class M>
+        pairib insert_or_assign(Key const& key, M&& obj);
+        template <class M>
+        pairib insert_or_assign(Key&& key, M&& obj);
+
+        iterator erase(iterator pos);
+        iterator erase(const_iterator first, const_iterator last);
+        size_type erase(Key const& key);
+
+        template <class Pred>
+        size_type erase_if(Pred pred);
+
+        size_type count(Key const& key) const;
+
+        iterator find(Key const& key);
+        const_iterator find(Key const& key) const;
+
+        pairit equal_range(Key const& key);
+        paircit equal_range(Key const& key) const;
+
+        iterator lower_bound(Key const& key);
+        const_iterator lower_bound(Key const& key) const;
+
+        iterator upper_bound(Key const& key);
+        const_iterator upper_bound(Key const& key) const;
+
+        bool contains(Key const& key) const;
+
+        key_compare key_comp() const;
+
+    private:
+        template <class, class>
+        friend struct smap_const_iterator;
+
+        typedef skip_list<value_type, RandomGen, smap_compare<Key, T, Compare>, Allocator, LevelGen>  list_type;
+
+        list_type  mList;
+    };
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    void swap(skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>& lhs, skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>& rhs)
+    {
+        lhs.swap(rhs);
+    }
+} // namespace algic
+
+namespace std
+{
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    void swap(algic::skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>& lhs, algic::skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>& rhs)
+    {
+        algic::swap(lhs, rhs);
+    }
+} // namespace std
+#include "skip_map.hpp"
+
+#endif
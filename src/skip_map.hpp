@@ -0,0 +1,455 @@
+#ifndef ALGORITHMIC_SKIP_MAP_HPP
+#define ALGORITHMIC_SKIP_MAP_HPP
+#include <stdexcept>
+#include <tuple>
+
+
+namespace algic
+{
+    /**********************************************************/
+    /*                  smap_const_iterator                   */
+
+    template <class Key, class T>
+    template <class SkipMap>
+    smap_const_iterator<Key, T>::smap_const_iterator(SkipMap const* smap, node<value_type>* nd)
+        : mHead(smap->mList.mHead)
+        , mNode(nd)
+    {
+    }
+
+    template <class Key, class T>
+    typename smap_const_iterator<Key, T>::value_type const& smap_const_iterator<Key, T>::operator*() const
+    {
+        return mNode->value();
+    }
+
+    template <class Key, class T>
+    typename smap_const_iterator<Key, T>::value_type const* smap_const_iterator<Key, T>::operator->() const
+    {
+        return &mNode->value();
+    }
+
+    template <class Key, class T>
+    smap_const_iterator<Key, T>& smap_const_iterator<Key, T>::operator++()
+    {
+        mNode = mNode->next(0);
+        return *this;
+    }
+
+    template <class Key, class T>
+    smap_const_iterator<Key, T> smap_const_iterator<Key, T>::operator++(int)
+    {
+        auto prevIter = *this;
+        mNode = mNode->next(0);
+        return prevIter;
+    }
+
+    template <class Key, class T>
+    smap_const_iterator<Key, T>& smap_const_iterator<Key, T>::operator--()
+    {
+        mNode = mNode ? mNode->prev(0) : mHead->prev(0);
+        return *this;
+    }
+
+    template <class Key, class T>
+    smap_const_iterator<Key, T> smap_const_iterator<Key, T>::operator--(int)
+    {
+        auto nextIter = *this;
+        --*this;
+        return nextIter;
+    }
+
+    template <class Key, class T>
+    bool smap_const_iterator<Key, T>::operator==(smap_const_iterator const& rhs) const
+    {
+        return mHead == rhs.mHead && mNode == rhs.mNode;
+    }
+
+    template <class Key, class T>
+    bool smap_const_iterator<Key, T>::operator!=(smap_const_iterator const& rhs) const
+    {
+        return mHead != rhs.mHead || mNode != rhs.mNode;
+    }
+
+
+    /**********************************************************/
+    /*                     smap_iterator                      */
+
+    template <class Key, class T>
+    template <class SkipMap>
+    smap_iterator<Key, T>::smap_iterator(SkipMap const* smap, node<value_type>* nd)
+        : smap_const_iterator<Key, T>(smap, nd)
+    {
+    }
+
+    template <class Key, class T>
+    typename smap_iterator<Key, T>::value_type& smap_iterator<Key, T>::operator*() const
+    {
+        return this->mNode->value();
+    }
+
+    template <class Key, class T>
+    typename smap_iterator<Key, T>::value_type* smap_iterator<Key, T>::operator->() const
+    {
+        return &this->mNode->value();
+    }
+
+    template <class Key, class T>
+    smap_iterator<Key, T>& smap_iterator<Key, T>::operator++()
+    {
+        this->mNode = this->mNode->next(0);
+        return *this;
+    }
+
+    template <class Key, class T>
+    smap_iterator<Key, T> smap_iterator<Key, T>::operator++(int)
+    {
+        auto prevIter = *this;
+        this->mNode = this->mNode->next(0);
+        return prevIter;
+    }
+
+    template <class Key, class T>
+    smap_iterator<Key, T>& smap_iterator<Key, T>::operator--()
+    {
+        smap_const_iterator<Key, T>::operator--();
+        return *this;
+    }
+
+    template <class Key, class T>
+    smap_iterator<Key, T> smap_iterator<Key, T>::operator--(int)
+    {
+        auto nextIter = *this;
+        smap_const_iterator<Key, T>::operator--();
+        return nextIter;
+    }
+
+
+    /**********************************************************/
+    /*                     smap_compare                       */
+
+    template <class Key, class T, class Compare>
+    smap_compare<Key, T, Compare>::smap_compare(Compare const& comp)
+        : mComp(comp)
+    {
+    }
+
+    template <class Key, class T, class Compare>
+    bool smap_compare<Key, T, Compare>::operator()(value_type const& lhs, value_type const& rhs) const
+    {
+        return mComp(lhs.first, rhs.first);
+    }
+
+    template <class Key, class T, class Compare>
+    bool smap_compare<Key, T, Compare>::operator()(value_type const& lhs, Key const& rhs) const
+    {
+        return mComp(lhs.first, rhs);
+    }
+
+    template <class Key, class T, class Compare>
+    bool smap_compare<Key, T, Compare>::operator()(Key const& lhs, value_type const& rhs) const
+    {
+        return mComp(lhs, rhs.first);
+    }
+
+
+    /**********************************************************/
+    /*                      skip_map                          */
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::skip_map(RandomGen& randGen, float prob, Compare const& comp, Allocator const& alloc)
+        : mList(randGen, prob, smap_compare<Key, T, Compare>(comp), alloc)
+    {
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::allocator_type skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::get_allocator() const
+    {
+        return mList.get_allocator();
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::iterator skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::begin()
+    {
+        return iterator(this, mList.mHead->next(0));
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::const_iterator skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::begin() const
+    {
+        return const_iterator(this, mList.mHead->next(0));
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::const_iterator skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::cbegin() const
+    {
+        return const_iterator(this, mList.mHead->next(0));
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::iterator skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::end()
+    {
+        return iterator(this, nullptr);
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::const_iterator skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::end() const
+    {
+        return const_iterator(this, nullptr);
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::const_iterator skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::cend() const
+    {
+        return const_iterator(this, nullptr);
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::reverse_iterator skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::rbegin()
+    {
+        return reverse_iterator(end());
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::const_reverse_iterator skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::rbegin() const
+    {
+        return const_reverse_iterator(end());
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::const_reverse_iterator skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::crbegin() const
+    {
+        return const_reverse_iterator(cend());
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::reverse_iterator skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::rend()
+    {
+        return reverse_iterator(begin());
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::const_reverse_iterator skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::rend() const
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::const_reverse_iterator skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::crend() const
+    {
+        return const_reverse_iterator(cbegin());
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    void skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::swap(skip_map& rhs)
+    {
+        mList.swap(rhs.mList);
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    bool skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::empty() const
+    {
+        return mList.empty();
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::size_type skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::size() const
+    {
+        return mList.size();
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    void skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::clear()
+    {
+        mList.clear();
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    T& skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::operator[](Key const& key)
+    {
+        return mList.emplaceKey(key, std::piecewise_construct,
+            std::forward_as_tuple(key), std::forward_as_tuple()).first->value().second;
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    T& skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::operator[](Key&& key)
+    {
+        // the key is only moved into the node once the search is over
+        return mList.emplaceKey(key, std::piecewise_construct,
+            std::forward_as_tuple(std::move(key)), std::forward_as_tuple()).first->value().second;
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    T& skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::at(Key const& key)
+    {
+        if (node<value_type>* found = mList.findNode(key))
+            return found->value().second;
+        throw std::out_of_range("Key is not in the skip_map");
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    T const& skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::at(Key const& key) const
+    {
+        if (node<value_type>* found = mList.findNode(key))
+            return found->value().second;
+        throw std::out_of_range("Key is not in the skip_map");
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::pairib skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::insert(value_type const& value)
+    {
+        auto const res = mList.emplaceKey(value.first, value);
+        return std::make_pair(iterator(this, res.first), res.second);
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::pairib skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::insert(value_type&& value)
+    {
+        auto const res = mList.emplaceKey(value.first, std::move(value));
+        return std::make_pair(iterator(this, res.first), res.second);
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    template <class... Args>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::pairib skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::try_emplace(Key const& key, Args&&... args)
+    {
+        auto const res = mList.emplaceKey(key, std::piecewise_construct,
+            std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+        return std::make_pair(iterator(this, res.first), res.second);
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    template <class... Args>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::pairib skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::try_emplace(Key&& key, Args&&... args)
+    {
+        auto const res = mList.emplaceKey(key, std::piecewise_construct,
+            std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+        return std::make_pair(iterator(this, res.first), res.second);
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    template <class M>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::pairib skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::insert_or_assign(Key const& key, M&& obj)
+    {
+        auto const res = mList.emplaceKey(key, std::piecewise_construct,
+            std::forward_as_tuple(key), std::forward_as_tuple(std::forward<M>(obj)));
+        if (!res.second)
+            res.first->value().second = std::forward<M>(obj);
+        return std::make_pair(iterator(this, res.first), res.second);
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    template <class M>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::pairib skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::insert_or_assign(Key&& key, M&& obj)
+    {
+        auto const res = mList.emplaceKey(key, std::piecewise_construct,
+            std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<M>(obj)));
+        if (!res.second)
+            res.first->value().second = std::forward<M>(obj);
+        return std::make_pair(iterator(this, res.first), res.second);
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::iterator skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::erase(iterator pos)
+    {
+        if (pos == end())
+            return end();
+        node<value_type>* nextNode = pos.mNode->next(0);
+        mList.unlinkNode(pos.mNode);
+        return iterator(this, nextNode);
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::iterator skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::erase(const_iterator first, const_iterator last)
+    {
+        mList.unlinkRun(first.mNode, last.mNode);
+        return iterator(this, last.mNode);
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::size_type skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::erase(Key const& key)
+    {
+        return mList.eraseKey(key);
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    template <class Pred>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::size_type skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::erase_if(Pred pred)
+    {
+        return mList.erase_if(pred);
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::size_type skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::count(Key const& key) const
+    {
+        return mList.findNode(key) ? 1 : 0;
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::iterator skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::find(Key const& key)
+    {
+        return iterator(this, mList.findNode(key));
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::const_iterator skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::find(Key const& key) const
+    {
+        return const_iterator(this, mList.findNode(key));
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::pairit skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::equal_range(Key const& key)
+    {
+        node<value_type>* first = mList.lowerBound(key);
+        node<value_type>* last = mList.isEqual(first, key) ? first->next(0) : first;
+        return std::make_pair(iterator(this, first), iterator(this, last));
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::paircit skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::equal_range(Key const& key) const
+    {
+        node<value_type>* first = mList.lowerBound(key);
+        node<value_type>* last = mList.isEqual(first, key) ? first->next(0) : first;
+        return std::make_pair(const_iterator(this, first), const_iterator(this, last));
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::iterator skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::lower_bound(Key const& key)
+    {
+        return iterator(this, mList.lowerBound(key));
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::const_iterator skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::lower_bound(Key const& key) const
+    {
+        return const_iterator(this, mList.lowerBound(key));
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::iterator skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::upper_bound(Key const& key)
+    {
+        node<value_type>* found = mList.lowerBound(key);
+        return iterator(this, mList.isEqual(found, key) ? found->next(0) : found);
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::const_iterator skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::upper_bound(Key const& key) const
+    {
+        node<value_type>* found = mList.lowerBound(key);
+        return const_iterator(this, mList.isEqual(found, key) ? found->next(0) : found);
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    bool skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::contains(Key const& key) const
+    {
+        return mList.findNode(key) != nullptr;
+    }
+
+    template <class Key, class T, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::key_compare skip_map<Key, T, RandomGen, Compare, Allocator, LevelGen>::key_comp() const
+    {
+        return mList.key_comp().mComp;
+    }
+} // namespace algic
+
+#endif
@@ -0,0 +1,151 @@
+#ifndef ALGORITHMIC_SKIP_MULTISET_H
+#define ALGORITHMIC_SKIP_MULTISET_H
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include "skip_list.h"
+
+
+namespace algic
+{
+    template <class Key, class RandomGen, class Compare = std::less<Key>,
+        class Allocator = std::allocator<Key>, class LevelGen = coin_level>
+    struct skip_multiset;
+
+
+    /**********************************************************/
+    /*                    skip_multiset                       */
+    // ordered multiset on the skip_list engine: a key goes in after the keys equal to it,
+    // so equal keys keep the order they were inserted in; the runs of equal keys are
+    // bounded by two searches, so count, equal_range and erase(key) take O(log n + k)
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    struct skip_multiset
+    {
+    private:
+        typedef skip_list<Key, RandomGen, Compare, Allocator, LevelGen>  list_type;
+
+    public:
+        typedef Key key_type;
+        typedef Key value_type;
+        typedef std::size_t  size_type;
+        typedef std::ptrdiff_t  difference_type;
+        typedef Compare key_compare;
+        typedef Compare value_compare;
+        typedef Allocator allocator_type;
+        typedef value_type& reference;
+        typedef value_type const& const_reference;
+        typedef typename list_type::iterator iterator;
+        typedef typename list_type::const_iterator const_iterator;
+        typedef std::pair<iterator, iterator>  pairit;
+        typedef std::pair<const_iterator, const_iterator>  paircit;
+        typedef std::reverse_iterator<iterator> reverse_iterator;
+        typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+        skip_multiset(RandomGen& randGen, float prob = 0.36787944117144f /* prob = 1 / e */,
+            Compare const& comp = Compare(), Allocator const& alloc = Allocator());
+
+        allocator_type get_allocator() const;
+
+        iterator begin();
+        const_iterator begin() const;
+        const_iterator cbegin() const;
+
+        iterator end();
+        const_iterator end() const;
+        const_iterator cend() const;
+
+        reverse_iterator rbegin();
+        const_reverse_iterator rbegin() const;
+        const_reverse_iterator crbegin() const;
+
+        reverse_iterator rend();
+        const_reverse_iterator rend() const;
+        const_reverse_iterator crend() const;
+
+        void swap(skip_multiset& rhs);
+
+        bool empty() const;
+
+        size_type size() const;
+
+        void clear();
+
+        // always inserts, after the keys equal to key
+        iterator insert(Key const& key);
+        iterator insert(Key&& key);
+
+        // every key is searched from the search path of the previous one when it is not
+        // less than it, so a sorted range is merged in one forward sweep and a run of
+        // equal keys is appended with no search at all: O(1) per key of the run
+        template <class IterType>
+        void insert(IterType first, IterType last);
+
+        void insert(std::initializer_list<value_type> ilist);
+
+        template <class... Args>
+        iterator emplace(Args&&... args);
+
+        // O(1) on average, the node is unlinked without a search
+        iterator erase(iterator pos);
+        const_iterator erase(const_iterator pos);
+        iterator erase(const_iterator first, const_iterator last);
+        // splices the whole run of key out at once
+        size_type erase(Key const& key);
+
+        size_type count(Key const& key) const;
+
+        // the first of the keys equal to key
+        iterator find(Key const& key);
+        const_iterator find(Key const& key) const;
+
+        pairit equal_range(Key const& key);
+        paircit equal_range(Key const& key) const;
+
+        iterator lower_bound(Key const& key);
+        const_iterator lower_bound(Key const& key) const;
+
+        iterator upper_bound(Key const& key);
+        const_iterator upper_bound(Key const& key) const;
+
+        bool contains(Key const& key) const;
+
+        key_compare key_comp() const;
+        value_compare value_comp() const;
+
+    private:
+        typedef typename list_type::update_path update_path;
+
+        // last node not greater than key at level 0, the head if there is none;
+        // visited gets the last such node at every level
+        node<Key>* visitUpper(Key const& key, update_path* visited) const;
+        // the same search, started from start at level levels - 1
+        node<Key>* visitUpperFrom(node<Key>* start, size_t levels, Key const& key, update_path* visited) const;
+        // the same search, started from path which is the search path of a key not greater than key
+        node<Key>* visitUpperAhead(update_path& path, Key const& key) const;
+        // true if the link of nd at level leads to a node not greater than key
+        bool linkNotAfter(node<Key> const* nd, size_t level, Key const& key) const;
+        // links newNode in after the keys equal to it, visited is its search path
+        iterator linkUpper(node<Key>* newNode, update_path const& visited);
+
+        list_type  mList;
+    };
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    void swap(skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>& lhs, skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>& rhs)
+    {
+        lhs.swap(rhs);
+    }
+} // namespace algic
+
+namespace std
+{
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    void swap(algic::skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>& lhs, algic::skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>& rhs)
+    {
+        algic::swap(lhs, rhs);
+    }
+} // namespace std
+#include "skip_multiset.hpp"
+
+#endif
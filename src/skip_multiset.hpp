@@ -0,0 +1,320 @@
+#ifndef ALGORITHMIC_SKIP_MULTISET_HPP
+#define ALGORITHMIC_SKIP_MULTISET_HPP
+
+
+namespace algic
+{
+    /**********************************************************/
+    /*                    skip_multiset                       */
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::skip_multiset(RandomGen& randGen, float prob, Compare const& comp, Allocator const& alloc)
+        : mList(randGen, prob, comp, alloc)
+    {
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::allocator_type skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::get_allocator() const
+    {
+        return mList.get_allocator();
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::iterator skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::begin()
+    {
+        return mList.begin();
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::const_iterator skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::begin() const
+    {
+        return mList.begin();
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::const_iterator skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::cbegin() const
+    {
+        return mList.cbegin();
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::iterator skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::end()
+    {
+        return mList.end();
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::const_iterator skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::end() const
+    {
+        return mList.end();
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::const_iterator skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::cend() const
+    {
+        return mList.cend();
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::reverse_iterator skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::rbegin()
+    {
+        return reverse_iterator(end());
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::const_reverse_iterator skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::rbegin() const
+    {
+        return const_reverse_iterator(end());
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::const_reverse_iterator skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::crbegin() const
+    {
+        return const_reverse_iterator(cend());
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::reverse_iterator skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::rend()
+    {
+        return reverse_iterator(begin());
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::const_reverse_iterator skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::rend() const
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::const_reverse_iterator skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::crend() const
+    {
+        return const_reverse_iterator(cbegin());
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    void skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::swap(skip_multiset& rhs)
+    {
+        mList.swap(rhs.mList);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    bool skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::empty() const
+    {
+        return mList.empty();
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::size_type skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::size() const
+    {
+        return mList.size();
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    void skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::clear()
+    {
+        mList.clear();
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::iterator skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::insert(Key const& key)
+    {
+        update_path visited;
+        visitUpper(key, &visited);
+        return linkUpper(node<Key>::create(mList.mAlloc, mList.multiCoin(), list_type::NodeLayout, key), visited);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::iterator skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::insert(Key&& key)
+    {
+        // the key is only moved into the node once the search is over
+        update_path visited;
+        visitUpper(key, &visited);
+        return linkUpper(node<Key>::create(mList.mAlloc, mList.multiCoin(), list_type::NodeLayout, std::move(key)), visited);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    template <class IterType>
+    void skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::insert(IterType first, IterType last)
+    {
+        update_path visited;
+        visited.fill(mList.mHead);
+        node<Key>* prevNode = nullptr;
+        for (; first != last; ++first)
+        {
+            // the path of a greater key is of no use, start over
+            if (prevNode && mList.mComp(*first, prevNode->value()))
+                visited.fill(mList.mHead);
+            visitUpperAhead(visited, *first);
+            prevNode = node<Key>::create(mList.mAlloc, mList.multiCoin(), list_type::NodeLayout, *first);
+            linkUpper(prevNode, visited);
+            // the new node is the last one not greater than its key at its levels
+            for (size_t i = 0; i < prevNode->height(); ++i)
+                visited[i] = prevNode;
+        }
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    void skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::insert(std::initializer_list<value_type> ilist)
+    {
+        insert(std::cbegin(ilist), std::cend(ilist));
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    template <class... Args>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::iterator skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::emplace(Args&&... args)
+    {
+        node<Key>* newNode = node<Key>::create(mList.mAlloc, mList.multiCoin(), list_type::NodeLayout, std::forward<Args>(args)...);
+        update_path visited;
+        visitUpper(newNode->value(), &visited);
+        return linkUpper(newNode, visited);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::iterator skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::erase(iterator pos)
+    {
+        return mList.erase(pos);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::const_iterator skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::erase(const_iterator pos)
+    {
+        return mList.erase(pos);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::iterator skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::erase(const_iterator first, const_iterator last)
+    {
+        return mList.erase(first, last);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::size_type skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::erase(Key const& key)
+    {
+        node<Key>* first = mList.lowerBound(key);
+        if (!mList.isEqual(first, key))
+            return 0;
+        return mList.unlinkRun(first, visitUpper(key, nullptr)->next(0));
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::size_type skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::count(Key const& key) const
+    {
+        size_type found = 0;
+        for (node<Key>* nd = mList.lowerBound(key); mList.isEqual(nd, key); nd = nd->next(0))
+            ++found;
+        return found;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::iterator skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::find(Key const& key)
+    {
+        return mList.find(key);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::const_iterator skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::find(Key const& key) const
+    {
+        return mList.find(key);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::pairit skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::equal_range(Key const& key)
+    {
+        return std::make_pair(lower_bound(key), upper_bound(key));
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::paircit skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::equal_range(Key const& key) const
+    {
+        return std::make_pair(lower_bound(key), upper_bound(key));
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::iterator skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::lower_bound(Key const& key)
+    {
+        return mList.lower_bound(key);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::const_iterator skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::lower_bound(Key const& key) const
+    {
+        return mList.lower_bound(key);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::iterator skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::upper_bound(Key const& key)
+    {
+        return iterator(&mList, visitUpper(key, nullptr)->next(0));
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::const_iterator skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::upper_bound(Key const& key) const
+    {
+        return const_iterator(&mList, visitUpper(key, nullptr)->next(0));
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    bool skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::contains(Key const& key) const
+    {
+        return mList.contains(key);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::key_compare skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::key_comp() const
+    {
+        return mList.key_comp();
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::value_compare skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::value_comp() const
+    {
+        return mList.value_comp();
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    node<Key>* skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::visitUpper(Key const& key, update_path* visited) const
+    {
+        return visitUpperFrom(mList.mHead, mList.mLevels, key, visited);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    node<Key>* skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::visitUpperFrom(node<Key>* start, size_t levels, Key const& key, update_path* visited) const
+    {
+        node<Key>* curNode = start;
+        for (size_t lvl = levels; lvl-- > 0;)
+        {
+            while (linkNotAfter(curNode, lvl, key))
+                curNode = curNode->next(lvl);
+            if (visited)
+                (*visited)[lvl] = curNode;
+        }
+        return curNode;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    node<Key>* skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::visitUpperAhead(update_path& path, Key const& key) const
+    {
+        // every node of path is not greater than key, the lowest level whose link is
+        // past key is right and so are the levels above it
+        size_t lvl = 0;
+        while (lvl + 1 < mList.mLevels && linkNotAfter(path[lvl], lvl, key))
+            ++lvl;
+        return visitUpperFrom(path[lvl], lvl + 1, key, &path);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    bool skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::linkNotAfter(node<Key> const* nd, size_t level, Key const& key) const
+    {
+        node<Key> const* nextNode = nd->next(level);
+        return nextNode && !mList.mComp(key, nextNode->value());
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen>
+    typename skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::iterator skip_multiset<Key, RandomGen, Compare, Allocator, LevelGen>::linkUpper(node<Key>* newNode, update_path const& visited)
+    {
+        mList.linkNode(newNode, visited);
+        return iterator(&mList, newNode);
+    }
+} // namespace algic
+
+#endif
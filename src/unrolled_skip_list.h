@@ -0,0 +1,272 @@
+#ifndef ALGORITHMIC_UNROLLED_SKIP_LIST_H
+#define ALGORITHMIC_UNROLLED_SKIP_LIST_H
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include "key_search.h"
+#include "skip_list.h"
+
+
+namespace algic
+{
+    template <class Key, std::size_t Capacity>
+    struct fat_node;
+
+    template <class Key, std::size_t Capacity>
+    struct fat_node_unit;
+
+    template <class Key, class RandomGen, class Compare = std::less<Key>, class Allocator = std::allocator<Key>,
+        class LevelGen = coin_level, std::size_t NodeKeys = 32>
+    struct unrolled_skip_list;
+
+    template <class Key, std::size_t NodeKeys>
+    struct uslist_iterator;
+
+    // points at a key inside a node, end() has no node
+    template <class Key, std::size_t NodeKeys>
+    struct uslist_const_iterator
+    {
+        typedef std::bidirectional_iterator_tag  iterator_category;
+        typedef Key  value_type;
+        typedef std::ptrdiff_t  difference_type;
+        typedef Key const*  pointer;
+        typedef Key const&  reference;
+
+        template <class SkipList>
+        uslist_const_iterator(SkipList const* slist, fat_node<Key, NodeKeys>* nd, std::size_t idx);
+
+        Key const& operator*() const;
+
+        uslist_const_iterator& operator++();
+        uslist_const_iterator operator++(int);
+
+        uslist_const_iterator& operator--();
+        uslist_const_iterator operator--(int);
+
+        bool operator==(uslist_const_iterator const& rhs) const;
+        bool operator!=(uslist_const_iterator const& rhs) const;
+
+    private:
+        template <class, class, class, class, class, std::size_t>
+        friend struct unrolled_skip_list;
+
+        fat_node<Key, NodeKeys>* mHead;
+        fat_node<Key, NodeKeys>* mNode;
+        std::size_t  mIndex;
+    };
+
+    template <class Key, std::size_t NodeKeys>
+    struct uslist_iterator : public uslist_const_iterator<Key, NodeKeys>
+    {
+        template <class SkipList>
+        uslist_iterator(SkipList const* slist, fat_node<Key, NodeKeys>* nd, std::size_t idx);
+    };
+
+
+    /**********************************************************/
+    /*                  unrolled_skip_list                    */
+    // Skip list whose nodes hold up to NodeKeys sorted keys each. The towers route by
+    // the first key of a node, the last step is a search inside the node's array, so
+    // scans read keys sequentially and the links cost a fraction of a pointer per key.
+    // A full node is split in halves, a node below a quarter full is merged with
+    // (or refilled from) its neighbour. Unlike skip_list, inserting or erasing a key
+    // moves its neighbours inside their nodes, so it invalidates all iterators.
+    // Keys are expected to be nothrow movable.
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    struct unrolled_skip_list
+    {
+        typedef Key key_type;
+        typedef Key value_type;
+        typedef std::size_t  size_type;
+        typedef std::ptrdiff_t  difference_type;
+        typedef Compare key_compare;
+        typedef Compare value_compare;
+        typedef Allocator allocator_type;
+        typedef value_type& reference;
+        typedef value_type const& const_reference;
+        typedef typename std::allocator_traits<Allocator>::pointer pointer;
+        typedef typename std::allocator_traits<Allocator>::const_pointer const_pointer;
+        typedef uslist_iterator<Key, NodeKeys> iterator;
+        typedef uslist_const_iterator<Key, NodeKeys> const_iterator;
+        typedef std::pair<iterator, bool> pairib;
+        typedef std::pair<iterator, iterator>  pairit;
+        typedef std::pair<const_iterator, const_iterator>  paircit;
+        typedef std::reverse_iterator<iterator> reverse_iterator;
+        typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+        static_assert(NodeKeys >= 4, "A node must hold at least 4 keys");
+
+        // towers count nodes, not keys, so the list holds up to about e^32 * NodeKeys keys
+        static constexpr size_t MaxHeight = 32;
+
+        unrolled_skip_list(RandomGen& randGen, float prob = 0.36787944117144f /* prob = 1 / e */,
+            Compare const& comp = Compare(), Allocator const& alloc = Allocator());
+        ~unrolled_skip_list();
+
+        unrolled_skip_list(unrolled_skip_list const&) = delete;
+        unrolled_skip_list& operator=(unrolled_skip_list const&) = delete;
+
+        allocator_type get_allocator() const;
+
+        iterator begin();
+        const_iterator begin() const;
+        const_iterator cbegin() const;
+
+        iterator end();
+        const_iterator end() const;
+        const_iterator cend() const;
+
+        reverse_iterator rbegin();
+        const_reverse_iterator rbegin() const;
+        const_reverse_iterator crbegin() const;
+
+        reverse_iterator rend();
+        const_reverse_iterator rend() const;
+        const_reverse_iterator crend() const;
+
+        void swap(unrolled_skip_list& rhs);
+
+        bool empty() const;
+
+        size_type size() const;
+
+        // number of nodes the keys are spread over
+        size_type nodes() const;
+
+        void clear();
+
+        pairib insert(Key const& key);
+
+        pairib insert(Key&& key);
+
+        template <class IterType>
+        void insert(IterType first, IterType last);
+
+        void insert(std::initializer_list<value_type> ilist);
+
+        // the key is built before the search, it is moved into its node
+        template <class... Args>
+        pairib emplace(Args&&... args);
+
+        iterator erase(iterator pos);
+        const_iterator erase(const_iterator pos);
+        size_type erase(Key const& key);
+
+        size_type count(Key const& key) const;
+        template <class K, class C = Compare, class = typename C::is_transparent>
+        size_type count(K const& key) const;
+
+        iterator find(Key const& key);
+        const_iterator find(Key const& key) const;
+        template <class K, class C = Compare, class = typename C::is_transparent>
+        iterator find(K const& key);
+        template <class K, class C = Compare, class = typename C::is_transparent>
+        const_iterator find(K const& key) const;
+
+        pairit equal_range(Key const& key);
+        paircit equal_range(Key const& key) const;
+        template <class K, class C = Compare, class = typename C::is_transparent>
+        pairit equal_range(K const& key);
+        template <class K, class C = Compare, class = typename C::is_transparent>
+        paircit equal_range(K const& key) const;
+
+        iterator lower_bound(Key const& key);
+        const_iterator lower_bound(Key const& key) const;
+        template <class K, class C = Compare, class = typename C::is_transparent>
+        iterator lower_bound(K const& key);
+        template <class K, class C = Compare, class = typename C::is_transparent>
+        const_iterator lower_bound(K const& key) const;
+
+        iterator upper_bound(Key const& key);
+        const_iterator upper_bound(Key const& key) const;
+        template <class K, class C = Compare, class = typename C::is_transparent>
+        iterator upper_bound(K const& key);
+        template <class K, class C = Compare, class = typename C::is_transparent>
+        const_iterator upper_bound(K const& key) const;
+
+        bool contains(Key const& key) const;
+        template <class K, class C = Compare, class = typename C::is_transparent>
+        bool contains(K const& key) const;
+
+        key_compare key_comp() const;
+        value_compare value_comp() const;
+
+    private:
+        template <class, std::size_t>
+        friend struct uslist_const_iterator;
+
+        typedef fat_node<Key, NodeKeys> node_type;
+        typedef typename std::allocator_traits<Allocator>::template rebind_alloc<fat_node_unit<Key, NodeKeys>> node_allocator;
+        // predecessors of a key at every level, kept on the stack by insert
+        typedef std::array<node_type*, MaxHeight> update_path;
+        // a node and the index of a key in it, { nullptr, 0 } is the end
+        typedef std::pair<node_type*, size_t> position;
+
+        // last node whose first key is not greater than key, the head if there is none;
+        // visited gets the last such node at every level
+        template <class K>
+        node_type* visit(K const& key, update_path* visited = nullptr) const;
+        // index of the first key of nd not less than key, count() if there is none,
+        // see key_search for the vectorized search of integral keys
+        template <class K>
+        size_t lowerIndex(node_type const* nd, K const& key) const;
+        template <class K>
+        size_t upperIndex(node_type const* nd, K const& key) const;
+        template <class K>
+        position lowerBound(K const& key) const;
+        template <class K>
+        position upperBound(K const& key) const;
+        template <class K>
+        position findPos(K const& key) const;
+        // pos is known not to be less than key
+        template <class K>
+        bool isEqual(position pos, K const& key) const;
+        // builds a key from args unless an element equal to key is present,
+        // returns where key is and whether it is a new one
+        template <class K, class... Args>
+        std::pair<position, bool> emplaceKey(K const& key, Args&&... args);
+        // links an empty node right after nd, visited is the search path ending at nd
+        node_type* linkNode(node_type* nd, update_path const& visited);
+        template <class K>
+        size_type eraseKey(K const& key);
+        // erases the key at pos and rebalances its node, returns the position of the next key
+        position eraseAt(position pos);
+        // merges right into left or evens their counts out, pos is moved along with its key
+        position rebalance(node_type* left, node_type* right, position pos);
+        // unlinks and destroys nd in O(height) through its prev links
+        void unlinkNode(node_type* nd);
+
+        void destroyNodes();
+        size_t multiCoin() const;
+
+        node_allocator mAlloc;
+        Compare mComp;
+        RandomGen& mRand;
+        LevelGen mLevelGen;
+        node_type* mHead{ nullptr };
+        size_t mLevels{ 1 }; // levels of the head tower in use
+        size_type mSize{ 0 };
+        size_type mNodes{ 0 };
+    };
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    void swap(unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>& lhs, unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>& rhs)
+    {
+        lhs.swap(rhs);
+    }
+} // namespace algic
+
+namespace std
+{
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    void swap(algic::unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>& lhs, algic::unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>& rhs)
+    {
+        algic::swap(lhs, rhs);
+    }
+} // namespace std
+#include "unrolled_skip_list.hpp"
+
+#endif
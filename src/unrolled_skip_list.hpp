@@ -0,0 +1,984 @@
+#ifndef ALGORITHMIC_UNROLLED_SKIP_LIST_HPP
+#define ALGORITHMIC_UNROLLED_SKIP_LIST_HPP
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+
+namespace algic
+{
+    // a node keeps its keys inline and its tower in front of itself, in a single allocation:
+    // [ prev links x height | next links x height | fat_node<Key, Capacity> ]
+    // so the count, the first key (the one searches compare with) and the lowest links
+    // share cache lines; the keys are the first count() slots of the array.
+    // the head of a list is a node with no keys, links point back as in skip_list:
+    // the first node of a level points to the head, the head's prev at level 0 is the last node
+    template <class Key, std::size_t Capacity>
+    struct fat_node
+    {
+        template <class Alloc>
+        static fat_node* create(Alloc& alloc, size_t height);
+        // destroys the keys left in nd as well
+        template <class Alloc>
+        static void destroy(Alloc& alloc, fat_node* nd);
+
+        static size_t units(size_t height);
+
+        size_t height() const;
+        size_t count() const;
+        fat_node* next(size_t level) const;
+        void set(size_t level, fat_node* nd);
+        fat_node* prev(size_t level) const;
+        void setPrev(size_t level, fat_node* nd);
+
+        Key& key(size_t idx);
+        Key const& key(size_t idx) const;
+
+        // builds a key at idx moving the keys from idx on one slot up, count() < Capacity
+        template <class... Args>
+        void emplace(size_t idx, Args&&... args);
+        // destroys the key at idx moving the keys past it one slot down
+        void erase(size_t idx);
+        // moves n keys of src starting at first to the back of this node
+        void appendFrom(fat_node& src, size_t first, size_t n);
+        // moves the last n keys of src to the front of this node
+        void prependFrom(fat_node& src, size_t n);
+        void destroyKeys();
+
+    private:
+        explicit fat_node(size_t height);
+
+        // bytes of the tower, rounded up so that the node stays aligned
+        static size_t towerBytes(size_t height);
+        // moves n keys to dst, the ranges may overlap, the source slots end up unconstructed
+        static void relocate(Key* dst, Key* src, size_t n, std::true_type);
+        static void relocate(Key* dst, Key* src, size_t n, std::false_type);
+        static void relocate(Key* dst, Key* src, size_t n);
+
+        Key* keys();
+        fat_node** tower();
+        fat_node* const* tower() const;
+
+        std::uint32_t  mHeight;
+        std::uint32_t  mCount{ 0 };
+        typename std::aligned_storage<sizeof(Key) * Capacity, alignof(Key)>::type  mKeys;
+    };
+
+    template <class Key, std::size_t Capacity>
+    struct alignas(fat_node<Key, Capacity>) alignas(void*) fat_node_unit
+    {
+        unsigned char  mBytes[alignof(fat_node<Key, Capacity>) > alignof(void*) ? alignof(fat_node<Key, Capacity>) : alignof(void*)];
+    };
+
+    /**********************************************************/
+    /*                  implementations                       */
+
+    /**********************************************************/
+    /*                       fat_node                         */
+    template <class Key, std::size_t Capacity>
+    template <class Alloc>
+    fat_node<Key, Capacity>* fat_node<Key, Capacity>::create(Alloc& alloc, size_t height)
+    {
+        char* mem = static_cast<char*>(static_cast<void*>(std::allocator_traits<Alloc>::allocate(alloc, units(height))));
+        return new (mem + towerBytes(height)) fat_node(height);
+    }
+
+    template <class Key, std::size_t Capacity>
+    template <class Alloc>
+    void fat_node<Key, Capacity>::destroy(Alloc& alloc, fat_node* nd)
+    {
+        nd->destroyKeys();
+        size_t const height = nd->mHeight;
+        char* mem = static_cast<char*>(static_cast<void*>(nd)) - towerBytes(height);
+        std::allocator_traits<Alloc>::deallocate(alloc,
+            static_cast<fat_node_unit<Key, Capacity>*>(static_cast<void*>(mem)), units(height));
+    }
+
+    template <class Key, std::size_t Capacity>
+    size_t fat_node<Key, Capacity>::units(size_t height)
+    {
+        size_t const bytes = towerBytes(height) + sizeof(fat_node);
+        return (bytes + sizeof(fat_node_unit<Key, Capacity>) - 1) / sizeof(fat_node_unit<Key, Capacity>);
+    }
+
+    template <class Key, std::size_t Capacity>
+    size_t fat_node<Key, Capacity>::towerBytes(size_t height)
+    {
+        size_t const unit = sizeof(fat_node_unit<Key, Capacity>);
+        return (2 * height * sizeof(fat_node*) + unit - 1) / unit * unit;
+    }
+
+    template <class Key, std::size_t Capacity>
+    fat_node<Key, Capacity>::fat_node(size_t height)
+        : mHeight(static_cast<std::uint32_t>(height))
+    {
+        std::fill(tower() - 2 * mHeight, tower(), nullptr);
+    }
+
+    template <class Key, std::size_t Capacity>
+    size_t fat_node<Key, Capacity>::height() const
+    {
+        return mHeight;
+    }
+
+    template <class Key, std::size_t Capacity>
+    size_t fat_node<Key, Capacity>::count() const
+    {
+        return mCount;
+    }
+
+    template <class Key, std::size_t Capacity>
+    fat_node<Key, Capacity>* fat_node<Key, Capacity>::next(size_t level) const
+    {
+        assert(level < mHeight && "Index out of range");
+        return tower()[-1 - std::ptrdiff_t(level)];
+    }
+
+    template <class Key, std::size_t Capacity>
+    void fat_node<Key, Capacity>::set(size_t level, fat_node* nd)
+    {
+        assert(level < mHeight && "Index out of range");
+        tower()[-1 - std::ptrdiff_t(level)] = nd;
+    }
+
+    template <class Key, std::size_t Capacity>
+    fat_node<Key, Capacity>* fat_node<Key, Capacity>::prev(size_t level) const
+    {
+        assert(level < mHeight && "Index out of range");
+        return tower()[-1 - std::ptrdiff_t(mHeight + level)];
+    }
+
+    template <class Key, std::size_t Capacity>
+    void fat_node<Key, Capacity>::setPrev(size_t level, fat_node* nd)
+    {
+        assert(level < mHeight && "Index out of range");
+        tower()[-1 - std::ptrdiff_t(mHeight + level)] = nd;
+    }
+
+    template <class Key, std::size_t Capacity>
+    Key& fat_node<Key, Capacity>::key(size_t idx)
+    {
+        assert(idx < mCount && "Index out of range");
+        return keys()[idx];
+    }
+
+    template <class Key, std::size_t Capacity>
+    Key const& fat_node<Key, Capacity>::key(size_t idx) const
+    {
+        assert(idx < mCount && "Index out of range");
+        return static_cast<Key const*>(static_cast<void const*>(&mKeys))[idx];
+    }
+
+    template <class Key, std::size_t Capacity>
+    template <class... Args>
+    void fat_node<Key, Capacity>::emplace(size_t idx, Args&&... args)
+    {
+        assert(idx <= mCount && mCount < Capacity && "Index out of range");
+        relocate(keys() + idx + 1, keys() + idx, mCount - idx);
+        try
+        {
+            new (static_cast<void*>(keys() + idx))Key(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            relocate(keys() + idx, keys() + idx + 1, mCount - idx);
+            throw;
+        }
+        ++mCount;
+    }
+
+    template <class Key, std::size_t Capacity>
+    void fat_node<Key, Capacity>::erase(size_t idx)
+    {
+        assert(idx < mCount && "Index out of range");
+        keys()[idx].~Key();
+        relocate(keys() + idx, keys() + idx + 1, mCount - idx - 1);
+        --mCount;
+    }
+
+    template <class Key, std::size_t Capacity>
+    void fat_node<Key, Capacity>::appendFrom(fat_node& src, size_t first, size_t n)
+    {
+        assert(first + n <= src.mCount && mCount + n <= Capacity && "Index out of range");
+        relocate(keys() + mCount, src.keys() + first, n);
+        relocate(src.keys() + first, src.keys() + first + n, src.mCount - first - n);
+        mCount += static_cast<std::uint32_t>(n);
+        src.mCount -= static_cast<std::uint32_t>(n);
+    }
+
+    template <class Key, std::size_t Capacity>
+    void fat_node<Key, Capacity>::prependFrom(fat_node& src, size_t n)
+    {
+        assert(n <= src.mCount && mCount + n <= Capacity && "Index out of range");
+        relocate(keys() + n, keys(), mCount);
+        relocate(keys(), src.keys() + src.mCount - n, n);
+        mCount += static_cast<std::uint32_t>(n);
+        src.mCount -= static_cast<std::uint32_t>(n);
+    }
+
+    template <class Key, std::size_t Capacity>
+    void fat_node<Key, Capacity>::destroyKeys()
+    {
+        for (size_t i = 0; i < mCount; ++i)
+            keys()[i].~Key();
+        mCount = 0;
+    }
+
+    template <class Key, std::size_t Capacity>
+    void fat_node<Key, Capacity>::relocate(Key* dst, Key* src, size_t n, std::true_type)
+    {
+        if (n)
+            std::memmove(static_cast<void*>(dst), static_cast<void const*>(src), n * sizeof(Key));
+    }
+
+    template <class Key, std::size_t Capacity>
+    void fat_node<Key, Capacity>::relocate(Key* dst, Key* src, size_t n, std::false_type)
+    {
+        // a slot is overwritten only once its own key has been moved away
+        if (dst < src)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                new (static_cast<void*>(dst + i))Key(std::move(src[i]));
+                src[i].~Key();
+            }
+        }
+        else
+        {
+            for (size_t i = n; i-- > 0;)
+            {
+                new (static_cast<void*>(dst + i))Key(std::move(src[i]));
+                src[i].~Key();
+            }
+        }
+    }
+
+    template <class Key, std::size_t Capacity>
+    void fat_node<Key, Capacity>::relocate(Key* dst, Key* src, size_t n)
+    {
+        relocate(dst, src, n, typename std::is_trivially_copyable<Key>::type());
+    }
+
+    template <class Key, std::size_t Capacity>
+    Key* fat_node<Key, Capacity>::keys()
+    {
+        return static_cast<Key*>(static_cast<void*>(&mKeys));
+    }
+
+    template <class Key, std::size_t Capacity>
+    fat_node<Key, Capacity>** fat_node<Key, Capacity>::tower()
+    {
+        // the tower ends right at the node, level 0 closest to it
+        return reinterpret_cast<fat_node**>(this);
+    }
+
+    template <class Key, std::size_t Capacity>
+    fat_node<Key, Capacity>* const* fat_node<Key, Capacity>::tower() const
+    {
+        return reinterpret_cast<fat_node* const*>(this);
+    }
+
+
+    /**********************************************************/
+    /*                uslist_const_iterator                   */
+
+    template <class Key, std::size_t NodeKeys>
+    template <class SkipList>
+    uslist_const_iterator<Key, NodeKeys>::uslist_const_iterator(SkipList const* slist, fat_node<Key, NodeKeys>* nd, std::size_t idx)
+        : mHead(slist->mHead)
+        , mNode(nd)
+        , mIndex(idx)
+    {
+    }
+
+    template <class Key, std::size_t NodeKeys>
+    Key const& uslist_const_iterator<Key, NodeKeys>::operator*() const
+    {
+        return mNode->key(mIndex);
+    }
+
+    template <class Key, std::size_t NodeKeys>
+    uslist_const_iterator<Key, NodeKeys>& uslist_const_iterator<Key, NodeKeys>::operator++()
+    {
+        if (++mIndex == mNode->count())
+        {
+            mNode = mNode->next(0);
+            mIndex = 0;
+        }
+        return *this;
+    }
+
+    template <class Key, std::size_t NodeKeys>
+    uslist_const_iterator<Key, NodeKeys> uslist_const_iterator<Key, NodeKeys>::operator++(int)
+    {
+        auto prevIter = *this;
+        ++*this;
+        return prevIter;
+    }
+
+    template <class Key, std::size_t NodeKeys>
+    uslist_const_iterator<Key, NodeKeys>& uslist_const_iterator<Key, NodeKeys>::operator--()
+    {
+        if (mIndex == 0)
+        {
+            // end() has no node, the node before it is the last one
+            mNode = mNode ? mNode->prev(0) : mHead->prev(0);
+            mIndex = mNode->count();
+        }
+        --mIndex;
+        return *this;
+    }
+
+    template <class Key, std::size_t NodeKeys>
+    uslist_const_iterator<Key, NodeKeys> uslist_const_iterator<Key, NodeKeys>::operator--(int)
+    {
+        auto nextIter = *this;
+        --*this;
+        return nextIter;
+    }
+
+    template <class Key, std::size_t NodeKeys>
+    bool uslist_const_iterator<Key, NodeKeys>::operator==(uslist_const_iterator const& rhs) const
+    {
+        return mHead == rhs.mHead && mNode == rhs.mNode && mIndex == rhs.mIndex;
+    }
+
+    template <class Key, std::size_t NodeKeys>
+    bool uslist_const_iterator<Key, NodeKeys>::operator!=(uslist_const_iterator const& rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+    template <class Key, std::size_t NodeKeys>
+    template <class SkipList>
+    uslist_iterator<Key, NodeKeys>::uslist_iterator(SkipList const* slist, fat_node<Key, NodeKeys>* nd, std::size_t idx)
+        : uslist_const_iterator<Key, NodeKeys>(slist, nd, idx)
+    {
+    }
+
+    /**********************************************************/
+    /*                  unrolled_skip_list                    */
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    constexpr size_t unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::MaxHeight;
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::unrolled_skip_list(RandomGen& randGen, float prob, Compare const& comp, Allocator const& alloc)
+        : mAlloc(alloc)
+        , mComp(comp)
+        , mRand(randGen)
+        , mLevelGen(prob)
+    {
+        if (prob < 0.0f || prob > 1.0f)
+            throw std::invalid_argument("Probabiliry must be in [0, 1] range");
+        mHead = node_type::create(mAlloc, MaxHeight);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::~unrolled_skip_list()
+    {
+        destroyNodes();
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::allocator_type unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::get_allocator() const
+    {
+        return allocator_type(mAlloc);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::iterator unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::begin()
+    {
+        return iterator(this, mHead->next(0), 0);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::const_iterator unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::begin() const
+    {
+        return const_iterator(this, mHead->next(0), 0);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::const_iterator unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::cbegin() const
+    {
+        return const_iterator(this, mHead->next(0), 0);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::iterator unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::end()
+    {
+        return iterator(this, nullptr, 0);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::const_iterator unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::end() const
+    {
+        return const_iterator(this, nullptr, 0);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::const_iterator unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::cend() const
+    {
+        return const_iterator(this, nullptr, 0);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::reverse_iterator unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::rbegin()
+    {
+        return reverse_iterator(end());
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::const_reverse_iterator unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::rbegin() const
+    {
+        return const_reverse_iterator(end());
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::const_reverse_iterator unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::crbegin() const
+    {
+        return const_reverse_iterator(cend());
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::reverse_iterator unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::rend()
+    {
+        return reverse_iterator(begin());
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::const_reverse_iterator unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::rend() const
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::const_reverse_iterator unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::crend() const
+    {
+        return const_reverse_iterator(cbegin());
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    void unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::swap(unrolled_skip_list& rhs)
+    {
+        std::swap(mAlloc, rhs.mAlloc);
+        std::swap(mComp, rhs.mComp);
+        std::swap(mLevelGen, rhs.mLevelGen);
+        std::swap(mHead, rhs.mHead);
+        std::swap(mLevels, rhs.mLevels);
+        std::swap(mSize, rhs.mSize);
+        std::swap(mNodes, rhs.mNodes);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    bool unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::empty() const
+    {
+        return (mHead->next(0) == nullptr);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::size_type unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::size() const
+    {
+        return mSize;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::size_type unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::nodes() const
+    {
+        return mNodes;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    void unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::clear()
+    {
+        destroyNodes();
+        mHead = node_type::create(mAlloc, MaxHeight);
+        mLevels = 1;
+        mSize = 0;
+        mNodes = 0;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::pairib unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::insert(Key const& key)
+    {
+        auto const res = emplaceKey(key, key);
+        return std::make_pair(iterator(this, res.first.first, res.first.second), res.second);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::pairib unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::insert(Key&& key)
+    {
+        // the key is only moved into the node once the search is over
+        auto const res = emplaceKey(key, std::move(key));
+        return std::make_pair(iterator(this, res.first.first, res.first.second), res.second);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    template <class IterType>
+    void unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::insert(IterType first, IterType last)
+    {
+        for (auto it = first; it != last; ++it)
+        {
+            insert(*it);
+        }
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    void unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::insert(std::initializer_list<value_type> ilist)
+    {
+        insert(std::cbegin(ilist), std::cend(ilist));
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    template <class... Args>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::pairib unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::emplace(Args&&... args)
+    {
+        Key key(std::forward<Args>(args)...);
+        auto const res = emplaceKey(key, std::move(key));
+        return std::make_pair(iterator(this, res.first.first, res.first.second), res.second);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::iterator unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::erase(iterator pos)
+    {
+        if (pos == end())
+            return end();
+        position const nextPos = eraseAt(position(pos.mNode, pos.mIndex));
+        return iterator(this, nextPos.first, nextPos.second);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::const_iterator unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::erase(const_iterator pos)
+    {
+        if (pos == end())
+            return cend();
+        position const nextPos = eraseAt(position(pos.mNode, pos.mIndex));
+        return const_iterator(this, nextPos.first, nextPos.second);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::size_type unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::erase(Key const& key)
+    {
+        return eraseKey(key);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::size_type unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::count(Key const& key) const
+    {
+        return isEqual(lowerBound(key), key) ? 1 : 0;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    template <class K, class C, class>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::size_type unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::count(K const& key) const
+    {
+        return isEqual(lowerBound(key), key) ? 1 : 0;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::iterator unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::find(Key const& key)
+    {
+        position const pos = findPos(key);
+        return iterator(this, pos.first, pos.second);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    template <class K, class C, class>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::iterator unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::find(K const& key)
+    {
+        position const pos = findPos(key);
+        return iterator(this, pos.first, pos.second);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::const_iterator unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::find(Key const& key) const
+    {
+        position const pos = findPos(key);
+        return const_iterator(this, pos.first, pos.second);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    template <class K, class C, class>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::const_iterator unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::find(K const& key) const
+    {
+        position const pos = findPos(key);
+        return const_iterator(this, pos.first, pos.second);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::pairit unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::equal_range(Key const& key)
+    {
+        return std::make_pair(lower_bound(key), upper_bound(key));
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    template <class K, class C, class>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::pairit unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::equal_range(K const& key)
+    {
+        return std::make_pair(lower_bound(key), upper_bound(key));
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::paircit unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::equal_range(Key const& key) const
+    {
+        return std::make_pair(lower_bound(key), upper_bound(key));
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    template <class K, class C, class>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::paircit unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::equal_range(K const& key) const
+    {
+        return std::make_pair(lower_bound(key), upper_bound(key));
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::iterator unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::lower_bound(Key const& key)
+    {
+        position const pos = lowerBound(key);
+        return iterator(this, pos.first, pos.second);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    template <class K, class C, class>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::iterator unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::lower_bound(K const& key)
+    {
+        position const pos = lowerBound(key);
+        return iterator(this, pos.first, pos.second);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::const_iterator unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::lower_bound(Key const& key) const
+    {
+        position const pos = lowerBound(key);
+        return const_iterator(this, pos.first, pos.second);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    template <class K, class C, class>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::const_iterator unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::lower_bound(K const& key) const
+    {
+        position const pos = lowerBound(key);
+        return const_iterator(this, pos.first, pos.second);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::iterator unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::upper_bound(Key const& key)
+    {
+        position const pos = upperBound(key);
+        return iterator(this, pos.first, pos.second);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    template <class K, class C, class>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::iterator unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::upper_bound(K const& key)
+    {
+        position const pos = upperBound(key);
+        return iterator(this, pos.first, pos.second);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::const_iterator unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::upper_bound(Key const& key) const
+    {
+        position const pos = upperBound(key);
+        return const_iterator(this, pos.first, pos.second);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    template <class K, class C, class>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::const_iterator unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::upper_bound(K const& key) const
+    {
+        position const pos = upperBound(key);
+        return const_iterator(this, pos.first, pos.second);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    bool unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::contains(Key const& key) const
+    {
+        return isEqual(lowerBound(key), key);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    template <class K, class C, class>
+    bool unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::contains(K const& key) const
+    {
+        return isEqual(lowerBound(key), key);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::key_compare unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::key_comp() const
+    {
+        return mComp;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::value_compare unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::value_comp() const
+    {
+        return mComp;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    template <class K>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::node_type* unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::visit(K const& key, update_path* visited) const
+    {
+        node_type* curNode = mHead;
+        for (size_t lvl = mLevels; lvl-- > 0;)
+        {
+            node_type* nextNode = curNode->next(lvl);
+            while (nextNode && !mComp(key, nextNode->key(0)))
+            {
+                curNode = nextNode;
+                nextNode = curNode->next(lvl);
+            }
+            if (visited)
+                (*visited)[lvl] = curNode;
+        }
+        return curNode;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    template <class K>
+    size_t unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::lowerIndex(node_type const* nd, K const& key) const
+    {
+        return key_search<Key, Compare>::lower(&nd->key(0), nd->count(), key, mComp);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    template <class K>
+    size_t unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::upperIndex(node_type const* nd, K const& key) const
+    {
+        return key_search<Key, Compare>::upper(&nd->key(0), nd->count(), key, mComp);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    template <class K>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::position unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::lowerBound(K const& key) const
+    {
+        // keys of the node found are not greater than key up to its first one,
+        // past the node they are all greater
+        node_type* curNode = visit(key);
+        if (curNode == mHead)
+            return position(mHead->next(0), 0);
+        size_t const idx = lowerIndex(curNode, key);
+        return idx < curNode->count() ? position(curNode, idx) : position(curNode->next(0), 0);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    template <class K>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::position unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::upperBound(K const& key) const
+    {
+        node_type* curNode = visit(key);
+        if (curNode == mHead)
+            return position(mHead->next(0), 0);
+        size_t const idx = upperIndex(curNode, key);
+        return idx < curNode->count() ? position(curNode, idx) : position(curNode->next(0), 0);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    template <class K>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::position unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::findPos(K const& key) const
+    {
+        position const pos = lowerBound(key);
+        return isEqual(pos, key) ? pos : position(nullptr, 0);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    template <class K>
+    bool unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::isEqual(position pos, K const& key) const
+    {
+        return pos.first && !mComp(key, pos.first->key(pos.second));
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    template <class K, class... Args>
+    std::pair<typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::position, bool> unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::emplaceKey(K const& key, Args&&... args)
+    {
+        update_path visited;
+        node_type* curNode = visit(key, &visited);
+        size_t idx = 0;
+        if (curNode == mHead)
+        {
+            // key goes in front of the first node, an empty list gets its first node
+            curNode = mHead->next(0);
+            if (!curNode)
+                curNode = linkNode(mHead, visited);
+        }
+        else
+        {
+            idx = lowerIndex(curNode, key);
+            if (idx < curNode->count() && !mComp(key, curNode->key(idx)))
+                return std::make_pair(position(curNode, idx), false);
+        }
+
+        if (curNode->count() == NodeKeys)
+        {
+            node_type* newNode = linkNode(curNode, visited);
+            if (idx == NodeKeys && !newNode->next(0))
+            {
+                // appending to the back starts a new node, ascending fills leave full nodes behind
+                curNode = newNode;
+                idx = 0;
+            }
+            else
+            {
+                size_t const half = NodeKeys / 2;
+                newNode->appendFrom(*curNode, half, NodeKeys - half);
+                if (idx > half)
+                {
+                    curNode = newNode;
+                    idx -= half;
+                }
+            }
+        }
+        curNode->emplace(idx, std::forward<Args>(args)...);
+        ++mSize;
+        return std::make_pair(position(curNode, idx), true);
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::node_type* unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::linkNode(node_type* nd, update_path const& visited)
+    {
+        size_t const newHeight = multiCoin();
+        node_type* newNode = node_type::create(mAlloc, newHeight);
+        ++mNodes;
+        for (size_t i = 0; i < newHeight; ++i)
+        {
+            // nd is the last node at or before the new one on its own levels,
+            // above them the search path is, and the head above the levels in use
+            node_type* prevNode = i < nd->height() ? nd : i < mLevels ? visited[i] : mHead;
+            node_type* nextNode = prevNode->next(i);
+            newNode->set(i, nextNode);
+            newNode->setPrev(i, prevNode);
+            if (nextNode)
+                nextNode->setPrev(i, newNode);
+            prevNode->set(i, newNode);
+        }
+        if (!newNode->next(0))
+            mHead->setPrev(0, newNode);
+        mLevels = std::max(mLevels, newHeight);
+        return newNode;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    template <class K>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::size_type unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::eraseKey(K const& key)
+    {
+        position const pos = findPos(key);
+        if (!pos.first)
+            return 0;
+        eraseAt(pos);
+        return 1;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::position unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::eraseAt(position pos)
+    {
+        node_type* nd = pos.first;
+        nd->erase(pos.second);
+        --mSize;
+        if (pos.second == nd->count())
+            pos = position(nd->next(0), 0);
+
+        if (nd->count() == 0)
+            unlinkNode(nd);
+        else if (nd->count() < NodeKeys / 4)
+        {
+            if (nd->next(0))
+                pos = rebalance(nd, nd->next(0), pos);
+            else if (nd->prev(0) != mHead)
+                pos = rebalance(nd->prev(0), nd, pos);
+        }
+        return pos;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    typename unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::position unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::rebalance(node_type* left, node_type* right, position pos)
+    {
+        size_t const leftCount = left->count();
+        size_t const total = leftCount + right->count();
+        if (total <= NodeKeys)
+        {
+            if (pos.first == right)
+                pos = position(left, leftCount + pos.second);
+            left->appendFrom(*right, 0, right->count());
+            unlinkNode(right);
+            return pos;
+        }
+
+        // both end up at least half full
+        size_t const half = total / 2;
+        if (leftCount > half)
+        {
+            size_t const moved = leftCount - half;
+            if (pos.first == right)
+                pos.second += moved;
+            else if (pos.first == left && pos.second >= half)
+                pos = position(right, pos.second - half);
+            right->prependFrom(*left, moved);
+        }
+        else
+        {
+            size_t const moved = half - leftCount;
+            if (pos.first == right)
+                pos = pos.second < moved ? position(left, leftCount + pos.second) : position(right, pos.second - moved);
+            left->appendFrom(*right, 0, moved);
+        }
+        return pos;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    void unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::unlinkNode(node_type* nd)
+    {
+        for (size_t i = 0; i < nd->height(); ++i)
+        {
+            node_type* prevNode = nd->prev(i);
+            node_type* nextNode = nd->next(i);
+            prevNode->set(i, nextNode);
+            if (nextNode)
+                nextNode->setPrev(i, prevNode);
+        }
+        if (!nd->next(0))
+            mHead->setPrev(0, nd->prev(0));
+        node_type::destroy(mAlloc, nd);
+        --mNodes;
+        while (mLevels > 1 && !mHead->next(mLevels - 1))
+            --mLevels;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    void unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::destroyNodes()
+    {
+        // destroys the head too, see skip_list::destroyNodes
+        bool const bulk = bulk_release<node_allocator>::possible(mAlloc);
+        if (!bulk || !std::is_trivially_destructible<Key>::value)
+        {
+            node_type* curNode = mHead->next(0);
+            while (curNode)
+            {
+                node_type* nextNode = curNode->next(0);
+                if (bulk)
+                    curNode->destroyKeys();
+                else
+                    node_type::destroy(mAlloc, curNode);
+                curNode = nextNode;
+            }
+        }
+        if (bulk)
+            bulk_release<node_allocator>::release(mAlloc);
+        else
+            node_type::destroy(mAlloc, mHead);
+        mHead = nullptr;
+    }
+
+    template <class Key, class RandomGen, class Compare, class Allocator, class LevelGen, std::size_t NodeKeys>
+    size_t unrolled_skip_list<Key, RandomGen, Compare, Allocator, LevelGen, NodeKeys>::multiCoin() const
+    {
+        // a new node may top the list by one level at most
+        return mLevelGen(mRand, std::min(mLevels + 1, MaxHeight));
+    }
+} // namespace algic
+
+#endif
@@ -1,11 +1,18 @@
 #ifndef INCLUDE_TESTS_H
 #define INCLUDE_TESTS_H
 
+#include <map>
+#include <random>
 #include <stdexcept>
 #include <string>
 #include <gtest/gtest.h>
+#include "key_search.h"
+#include "pool_allocator.h"
 #include "random.h"
 #include "skip_list.h"
+#include "skip_map.h"
+#include "skip_multiset.h"
+#include "unrolled_skip_list.h"
 
 using namespace algic;
 
@@ -393,4 +400,1604 @@ TEST_F(SkipListFixture, UpperBound)
     }
 }
 
+TEST(PoolAllocatorTest, RecyclesBlocksBySize)
+{
+    block_pool pool(sizeof(void*), 1024);
+    void* small = pool.allocate(24);
+    void* big = pool.allocate(40);
+    EXPECT_EQ(1, pool.slabs());
+
+    pool.deallocate(small, 24);
+    pool.deallocate(big, 40);
+    EXPECT_EQ(big, pool.allocate(40));
+    EXPECT_EQ(small, pool.allocate(24));
+    EXPECT_EQ(1, pool.slabs());
+
+    pool.release();
+    EXPECT_EQ(0, pool.slabs());
+}
+
+TEST(PoolAllocatorTest, SkipListChurn)
+{
+    typedef skip_list<std::string, random<float>, std::less<std::string>, pool_allocator<std::string>> pool_slist;
+    random<int>  rand;
+    pool_slist  slist(SRand);
+    std::set<std::string>  st;
+    for (int k = 0; k < 10; ++k)
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            std::string const str = std::to_string(rand() % 2000);
+            EXPECT_EQ(st.insert(str).second, slist.insert(str).second);
+        }
+        for (int i = 0; i < 1000; ++i)
+        {
+            std::string const str = std::to_string(rand() % 2000);
+            EXPECT_EQ(st.erase(str), slist.erase(str));
+        }
+        ASSERT_EQ(st.size(), slist.size());
+        EXPECT_TRUE(std::equal(std::cbegin(st), std::cend(st), std::cbegin(slist)));
+        if (k % 3 == 0)
+        {
+            slist.clear();
+            st.clear();
+            EXPECT_TRUE(slist.empty());
+        }
+    }
+}
+
+TEST(PoolAllocatorTest, SharedPool)
+{
+    typedef skip_list<int, random<float>, std::less<int>, pool_allocator<int>> pool_slist;
+    pool_allocator<int>  alloc;
+    pool_slist  slist1(SRand, 0.5f, std::less<int>(), alloc);
+    pool_slist  slist2(SRand, 0.5f, std::less<int>(), alloc);
+    for (int i = 0; i < 1000; ++i)
+    {
+        slist1.insert(i);
+        slist2.insert(-i);
+    }
+    EXPECT_EQ(slist1.get_allocator(), slist2.get_allocator());
+
+    // clearing one list must not release the nodes of the other
+    slist1.clear();
+    EXPECT_EQ(1000, slist2.size());
+    int expected = -999;
+    for (int v : slist2)
+        EXPECT_EQ(expected++, v);
+}
+
+template <class LevelGen>
+std::vector<size_t> heightHistogram(float prob, size_t draws)
+{
+    LevelGen levelGen(prob);
+    random<float>  rand;
+    std::vector<size_t> hist(8, 0);
+    for (size_t i = 0; i < draws; ++i)
+    {
+        size_t const height = levelGen(rand, hist.size());
+        EXPECT_GE(height, 1);
+        EXPECT_LE(height, hist.size());
+        ++hist[height - 1];
+    }
+    return hist;
+}
+
+template <class LevelGen>
+void checkGeometric(float prob)
+{
+    size_t const draws = 200000;
+    auto hist = heightHistogram<LevelGen>(prob, draws);
+    // P(height == k) = prob^(k - 1) * (1 - prob) for all but the last, capped level
+    double expected = 1.0 - prob;
+    for (size_t k = 0; k + 1 < hist.size() && expected * draws > 1000; ++k)
+    {
+        EXPECT_NEAR(expected, double(hist[k]) / draws, 0.1 * expected) << "height " << k + 1;
+        expected *= prob;
+    }
+}
+
+TEST(LevelGeneratorTest, CoinIsGeometric)
+{
+    checkGeometric<coin_level>(0.5f);
+    checkGeometric<coin_level>(0.36787944117144f);
+}
+
+TEST(LevelGeneratorTest, WordIsGeometric)
+{
+    checkGeometric<word_level>(0.5f);
+    checkGeometric<word_level>(0.25f);
+    checkGeometric<word_level>(0.36787944117144f);
+    checkGeometric<word_level>(0.7f);
+}
+
+TEST(LevelGeneratorTest, Bounds)
+{
+    auto never = heightHistogram<word_level>(0.0f, 1000);
+    EXPECT_EQ(1000, never[0]);
+    auto always = heightHistogram<word_level>(1.0f, 1000);
+    EXPECT_EQ(1000, always.back());
+}
+
+TEST(LevelGeneratorTest, SkipListWithWordLevel)
+{
+    random<int>  rand;
+    skip_list<int, random<float>, std::less<int>, std::allocator<int>, word_level>  slist(SRand, 0.25f);
+    std::set<int>  st;
+    for (int i = 0; i < 10000; ++i)
+    {
+        int const num = rand() % 5000;
+        EXPECT_EQ(st.insert(num).second, slist.insert(num).second);
+    }
+    ASSERT_EQ(st.size(), slist.size());
+    EXPECT_TRUE(std::equal(std::cbegin(st), std::cend(st), std::cbegin(slist)));
+}
+
+TEST(SkipListCompareTest, Descending)
+{
+    random<int>  rand;
+    skip_list<int, random<float>, std::greater<int>>  slist(SRand);
+    std::set<int, std::greater<int>>  st;
+    for (int i = 0; i < 1000; ++i)
+    {
+        int const num = rand() % 500;
+        EXPECT_EQ(st.insert(num).second, slist.insert(num).second);
+    }
+    ASSERT_EQ(st.size(), slist.size());
+    EXPECT_TRUE(std::equal(std::cbegin(st), std::cend(st), std::cbegin(slist)));
+    for (int i = -1; i <= 500; ++i)
+    {
+        EXPECT_EQ(st.count(i), slist.count(i));
+        auto lwS = st.lower_bound(i);
+        auto lwL = slist.lower_bound(i);
+        if (lwS == std::end(st))
+            EXPECT_EQ(std::end(slist), lwL);
+        else
+            EXPECT_EQ(*lwS, *lwL);
+    }
+}
+
+// counts how many keys get constructed, lookups through a transparent comparator must build none
+struct counted_key
+{
+    explicit counted_key(int val)
+        : mVal(val)
+    {
+        ++sConstructed;
+    }
+
+    counted_key(counted_key const& rhs)
+        : mVal(rhs.mVal)
+    {
+        ++sConstructed;
+    }
+
+    int  mVal;
+    static size_t  sConstructed;
+};
+
+size_t counted_key::sConstructed = 0;
+
+struct counted_less
+{
+    typedef void is_transparent;
+
+    bool operator()(counted_key const& lhs, counted_key const& rhs) const
+    {
+        return lhs.mVal < rhs.mVal;
+    }
+
+    bool operator()(counted_key const& lhs, int rhs) const
+    {
+        return lhs.mVal < rhs;
+    }
+
+    bool operator()(int lhs, counted_key const& rhs) const
+    {
+        return lhs < rhs.mVal;
+    }
+};
+
+TEST(SkipListCompareTest, TransparentLookup)
+{
+    skip_list<counted_key, random<float>, counted_less>  slist(SRand);
+    for (int i = 0; i < 100; i += 2)
+        slist.insert(counted_key(i));
+
+    size_t const constructed = counted_key::sConstructed;
+    for (int i = -1; i <= 100; ++i)
+    {
+        bool const present = i >= 0 && i < 100 && i % 2 == 0;
+        EXPECT_EQ(present, slist.contains(i));
+        EXPECT_EQ(present ? 1 : 0, slist.count(i));
+        EXPECT_EQ(present, slist.find(i) != std::end(slist));
+
+        auto lw = slist.lower_bound(i);
+        auto up = slist.upper_bound(i);
+        int const expectedLw = i < 0 ? 0 : (i + 1) / 2 * 2;
+        int const expectedUp = i < 0 ? 0 : i / 2 * 2 + 2;
+        if (expectedLw < 100)
+            EXPECT_EQ(expectedLw, (*lw).mVal);
+        else
+            EXPECT_EQ(std::end(slist), lw);
+        if (expectedUp < 100)
+            EXPECT_EQ(expectedUp, (*up).mVal);
+        else
+            EXPECT_EQ(std::end(slist), up);
+
+        auto eqRange = slist.equal_range(i);
+        EXPECT_EQ(lw, eqRange.first);
+        EXPECT_EQ(up, eqRange.second);
+    }
+    EXPECT_EQ(constructed, counted_key::sConstructed);
+}
+
+TEST(SkipListCompareTest, StringByCString)
+{
+    skip_list<std::string, random<float>, std::less<>>  slist(SRand);
+    slist.insert({ "alpha", "beta", "gamma" });
+    EXPECT_TRUE(slist.contains("beta"));
+    EXPECT_FALSE(slist.contains("delta"));
+    EXPECT_EQ("gamma", *slist.lower_bound("delta"));
+    EXPECT_EQ("beta", *slist.find("beta"));
+}
+
+TEST(SkipMapTest, CompareWithStdMap)
+{
+    random<int>  rand;
+    skip_map<int, std::string, random<float>>  smap(SRand);
+    std::map<int, std::string>  mp;
+    for (int i = 0; i < 5000; ++i)
+    {
+        int const key = rand() % 1000;
+        std::string const val = std::to_string(rand());
+        switch (rand() % 4)
+        {
+        case 0:
+            smap[key] = val;
+            mp[key] = val;
+            break;
+        case 1:
+            EXPECT_EQ(mp.insert(std::make_pair(key, val)).second, smap.insert(std::make_pair(key, val)).second);
+            break;
+        case 2:
+            EXPECT_EQ(mp.count(key) == 0, smap.insert_or_assign(key, val).second);
+            mp[key] = val;
+            break;
+        default:
+            EXPECT_EQ(mp.erase(key), smap.erase(key));
+            break;
+        }
+    }
+
+    ASSERT_EQ(mp.size(), smap.size());
+    auto mIt = std::cbegin(mp);
+    for (auto const& kv : smap)
+    {
+        EXPECT_EQ(mIt->first, kv.first);
+        EXPECT_EQ(mIt->second, kv.second);
+        ++mIt;
+    }
+    for (int key = -1; key <= 1000; ++key)
+    {
+        EXPECT_EQ(mp.count(key), smap.count(key));
+        auto lwM = mp.lower_bound(key);
+        auto lwS = smap.lower_bound(key);
+        if (lwM == std::end(mp))
+            EXPECT_EQ(std::end(smap), lwS);
+        else
+            EXPECT_EQ(lwM->first, lwS->first);
+    }
+}
+
+TEST(SkipMapTest, MutableFind)
+{
+    skip_map<std::string, int, random<float>>  smap(SRand);
+    smap["one"] = 1;
+    smap["two"] = 2;
+
+    auto it = smap.find("two");
+    ASSERT_NE(std::end(smap), it);
+    it->second = 22;
+    EXPECT_EQ(22, smap.at("two"));
+    EXPECT_THROW(smap.at("three"), std::out_of_range);
+
+    auto const& csmap = smap;
+    EXPECT_EQ(1, csmap.find("one")->second);
+    EXPECT_EQ(std::cend(csmap), csmap.find("three"));
+}
+
+// counts copies and moves of a mapped value, try_emplace must build it in place exactly once
+struct tracked_value
+{
+    tracked_value(int a, int b)
+        : mSum(a + b)
+    {
+    }
+
+    tracked_value(tracked_value const& rhs)
+        : mSum(rhs.mSum)
+    {
+        ++sCopies;
+    }
+
+    tracked_value(tracked_value&& rhs)
+        : mSum(rhs.mSum)
+    {
+        ++sCopies;
+    }
+
+    tracked_value& operator=(tracked_value const&) = default;
+
+    int  mSum;
+    static size_t  sCopies;
+};
+
+size_t tracked_value::sCopies = 0;
+
+TEST(SkipMapTest, TryEmplaceInPlace)
+{
+    skip_map<int, tracked_value, random<float>>  smap(SRand);
+    for (int i = 0; i < 100; ++i)
+        EXPECT_TRUE(smap.try_emplace(i, i, 1).second);
+    for (int i = 0; i < 100; ++i)
+        EXPECT_FALSE(smap.try_emplace(i, 0, 0).second);
+    EXPECT_EQ(0, tracked_value::sCopies);
+
+    for (int i = 0; i < 100; ++i)
+        EXPECT_EQ(i + 1, smap.find(i)->second.mSum);
+}
+
+TEST(SkipListEmplaceTest, InPlace)
+{
+    skip_list<std::string, random<float>>  slist(SRand);
+    for (size_t i = 1; i <= 20; ++i)
+    {
+        auto res = slist.emplace(i, 'a');
+        EXPECT_TRUE(res.second);
+        EXPECT_EQ(std::string(i, 'a'), *res.first);
+    }
+    auto dup = slist.emplace(size_t(5), 'a');
+    EXPECT_FALSE(dup.second);
+    EXPECT_EQ("aaaaa", *dup.first);
+    EXPECT_EQ("b", *slist.emplace_hint(std::cbegin(slist), size_t(1), 'b'));
+    EXPECT_EQ(21, slist.size());
+    EXPECT_TRUE(std::is_sorted(std::cbegin(slist), std::cend(slist)));
+}
+
+TEST(SkipListEmplaceTest, BuildsOnlyAbsentKeys)
+{
+    skip_list<counted_key, random<float>, counted_less>  slist(SRand);
+    size_t constructed = counted_key::sConstructed;
+    for (int i = 0; i < 100; i += 2)
+        EXPECT_TRUE(slist.try_emplace(i).second);
+    EXPECT_EQ(constructed + 50, counted_key::sConstructed);
+
+    constructed = counted_key::sConstructed;
+    for (int i = 0; i < 100; ++i)
+        EXPECT_EQ(i % 2 != 0, slist.try_emplace(i).second);
+    EXPECT_EQ(constructed + 50, counted_key::sConstructed);
+
+    counted_key const present(10);
+    counted_key const absent(1000);
+    constructed = counted_key::sConstructed;
+    EXPECT_FALSE(slist.insert(present).second);
+    EXPECT_EQ(constructed, counted_key::sConstructed);
+    EXPECT_TRUE(slist.insert(absent).second);
+    EXPECT_EQ(constructed + 1, counted_key::sConstructed);
+    EXPECT_EQ(101, slist.size());
+}
+
+// a string key that counts the times it is built from a C string
+struct counted_str
+{
+    counted_str(char const* str)
+        : mStr(str)
+    {
+        ++sConstructed;
+    }
+
+    std::string  mStr;
+    static size_t  sConstructed;
+};
+
+size_t counted_str::sConstructed = 0;
+
+struct counted_str_less
+{
+    bool operator()(counted_str const& lhs, counted_str const& rhs) const
+    {
+        return lhs.mStr < rhs.mStr;
+    }
+};
+
+TEST(SkipListEmplaceTest, TryEmplaceCString)
+{
+    char const* const words[] = { "skip", "list", "tower", "level", "skip", "node", "list" };
+    std::set<std::string>  st;
+    skip_list<std::string, random<float>>  slist(SRand);
+    skip_list<std::string, random<float>, std::less<>>  transparent(SRand);
+    for (char const* word : words)
+    {
+        bool const absent = st.insert(word).second;
+        EXPECT_EQ(absent, slist.try_emplace(word).second);
+        auto const res = transparent.try_emplace(word);
+        EXPECT_EQ(absent, res.second);
+        EXPECT_EQ(word, *res.first);
+    }
+    EXPECT_TRUE(std::equal(std::cbegin(st), std::cend(st), std::cbegin(slist), std::cend(slist)));
+    EXPECT_TRUE(std::equal(std::cbegin(st), std::cend(st), std::cbegin(transparent), std::cend(transparent)));
+
+    // without a transparent comparator the key is built once, not once per comparison
+    skip_list<counted_str, random<float>, counted_str_less>  counted(SRand);
+    for (int round = 0; round < 2; ++round)
+    {
+        for (char const* word : { "a", "b", "c", "d", "e", "f", "g", "h", "i", "j", "k", "l" })
+        {
+            size_t const constructed = counted_str::sConstructed;
+            EXPECT_EQ(round == 0, counted.try_emplace(word).second);
+            EXPECT_EQ(constructed + 1, counted_str::sConstructed);
+        }
+    }
+    EXPECT_EQ(12, counted.size());
+}
+
+TEST(SkipListFingerTest, CompareWithSet)
+{
+    std::mt19937 gen(7);
+    std::set<int>  st;
+    skip_list<int, random<float>>  slist(SRand);
+    slist.finger_search(true);
+    EXPECT_TRUE(slist.finger_search());
+
+    // keys wander around a moving center, with a jump now and then
+    int center = 5000;
+    for (int i = 0; i < 20000; ++i)
+    {
+        if (i % 1000 == 0)
+            center = gen() % 10000;
+        int const key = center + int(gen() % 64) - 32;
+        switch (gen() % 4)
+        {
+        case 0:
+        case 1:
+            EXPECT_EQ(st.insert(key).second, slist.insert(key).second);
+            break;
+        case 2:
+            EXPECT_EQ(st.erase(key), slist.erase(key));
+            break;
+        default:
+            EXPECT_EQ(st.count(key), slist.count(key));
+            auto lw = slist.lower_bound(key);
+            if (st.lower_bound(key) == std::end(st))
+                EXPECT_EQ(std::end(slist), lw);
+            else
+                EXPECT_EQ(*st.lower_bound(key), *lw);
+        }
+        if (i % 5000 == 4999)
+            slist.finger_search(!slist.finger_search());
+    }
+    ASSERT_EQ(st.size(), slist.size());
+    EXPECT_TRUE(std::equal(std::cbegin(st), std::cend(st), std::cbegin(slist)));
+
+    slist.clear();
+    slist.finger_search(true);
+    for (int i = 1000; i-- > 0;)
+        slist.insert(i);
+    EXPECT_EQ(1000, slist.size());
+    EXPECT_TRUE(std::is_sorted(std::cbegin(slist), std::cend(slist)));
+}
+
+TEST(SkipListFingerTest, Hints)
+{
+    skip_list<int, random<float>>  slist(SRand);
+    auto hint = slist.cend();
+    for (int i = 0; i < 10000; i += 2)
+        hint = slist.insert(hint, i);
+    EXPECT_EQ(5000, slist.size());
+
+    // good, bad and end hints
+    for (int i = 1; i < 10000; i += 2)
+    {
+        auto const good = slist.find(i - 1);
+        auto const bad = slist.find(std::min(i + 101, 9998));
+        EXPECT_EQ(std::end(slist), slist.find(good, i));
+        EXPECT_EQ(i, *slist.insert(i % 3 ? good : bad, i));
+        EXPECT_EQ(i, *slist.find(good, i));
+        EXPECT_EQ(i, *slist.find(bad, i));
+        EXPECT_EQ(i, *slist.find(slist.cend(), i));
+        EXPECT_EQ(i, *slist.insert(good, i));
+    }
+    EXPECT_EQ(10000, slist.size());
+    EXPECT_TRUE(std::is_sorted(std::cbegin(slist), std::cend(slist)));
+    for (int i = 0; i < 10000; ++i)
+        EXPECT_TRUE(slist.contains(i));
+}
+
+TEST(SkipListBulkTest, AssignSorted)
+{
+    std::vector<int> keys;
+    for (int i = 0; i < 10000; ++i)
+        keys.push_back(i / 3 * 2); // every key three times
+    skip_list<int, random<float>>  slist(SRand);
+    slist.insert({ -5, 100000 });
+    slist.assign_sorted(std::cbegin(keys), std::cend(keys));
+    ASSERT_EQ(3334, slist.size());
+    EXPECT_TRUE(std::equal(std::cbegin(slist), std::cend(slist), std::cbegin(std::set<int>(std::cbegin(keys), std::cend(keys)))));
+
+    // the towers must serve searches and updates as if built one by one
+    for (int i = -1; i < 6668; ++i)
+        EXPECT_EQ(i >= 0 && i % 2 == 0, slist.contains(i));
+    for (int i = 1; i < 6668; i += 2)
+        EXPECT_TRUE(slist.insert(i).second);
+    for (int i = 0; i < 6668; i += 4)
+        EXPECT_EQ(1, slist.erase(i));
+    EXPECT_EQ(3334 + 3334 - 1667, slist.size());
+    EXPECT_TRUE(std::is_sorted(std::cbegin(slist), std::cend(slist)));
+}
+
+TEST(SkipListBulkTest, AssignUnsorted)
+{
+    std::vector<std::string> keys{ "delta", "alpha", "echo", "alpha", "charlie", "bravo" };
+    skip_list<std::string, random<float>>  slist(SRand);
+    slist.assign_sorted(std::cbegin(keys), std::cend(keys));
+    std::vector<std::string> const expected{ "alpha", "bravo", "charlie", "delta", "echo" };
+    ASSERT_EQ(expected.size(), slist.size());
+    EXPECT_TRUE(std::equal(std::cbegin(expected), std::cend(expected), std::cbegin(slist)));
+
+    skip_list<int, random<float>, std::greater<int>>  desc(SRand);
+    std::vector<int> const nums{ 1, 2, 3 };
+    desc.assign_sorted(std::cbegin(nums), std::cend(nums));
+    EXPECT_EQ(3, *std::cbegin(desc));
+    desc.assign_sorted(std::cend(nums), std::cend(nums));
+    EXPECT_TRUE(desc.empty());
+}
+
+TEST(SkipListBulkTest, InsertBatch)
+{
+    std::mt19937 gen(11);
+    std::set<int>  st;
+    skip_list<int, random<float>>  slist(SRand);
+    slist.finger_search(true);
+    for (size_t batchSize : { 0, 1, 7, 100, 1000, 5000 })
+    {
+        std::vector<int> batch;
+        for (size_t i = 0; i < batchSize; ++i)
+            batch.push_back(int(gen() % 20000));
+        size_t const oldSize = st.size();
+        st.insert(std::cbegin(batch), std::cend(batch));
+        EXPECT_EQ(st.size() - oldSize, slist.insert_batch(std::cbegin(batch), std::cend(batch)));
+        ASSERT_EQ(st.size(), slist.size());
+        EXPECT_TRUE(std::equal(std::cbegin(st), std::cend(st), std::cbegin(slist)));
+    }
+    for (int i = 0; i < 20000; ++i)
+        EXPECT_EQ(st.erase(i), slist.erase(i));
+    EXPECT_TRUE(slist.empty());
+}
+
+TEST(SkipListReverseTest, CompareWithSet)
+{
+    std::mt19937 gen(13);
+    std::set<int>  st;
+    skip_list<int, random<float>>  slist(SRand);
+    for (int i = 0; i < 5000; ++i)
+    {
+        int const key = int(gen() % 2000);
+        if (gen() % 3)
+            EXPECT_EQ(st.insert(key).second, slist.insert(key).second);
+        else
+            EXPECT_EQ(st.erase(key), slist.erase(key));
+    }
+    ASSERT_EQ(st.size(), slist.size());
+    EXPECT_TRUE(std::equal(std::crbegin(st), std::crend(st), std::crbegin(slist), std::crend(slist)));
+    EXPECT_EQ(*st.rbegin(), *std::prev(std::end(slist)));
+
+    // walk back from the bounds
+    for (int key = 1; key < 2000; key += 97)
+    {
+        auto itS = st.lower_bound(key);
+        auto itL = slist.lower_bound(key);
+        for (int k = 0; k < 10 && itS != std::begin(st); ++k)
+        {
+            --itS;
+            --itL;
+            EXPECT_EQ(*itS, *itL);
+        }
+        EXPECT_EQ(*std::prev(st.upper_bound(key)), *std::prev(slist.upper_bound(key)));
+    }
+
+    skip_list<int, random<float>>  single(SRand);
+    single.insert(42);
+    EXPECT_EQ(42, *single.rbegin());
+    EXPECT_EQ(std::begin(single), --std::end(single));
+    single.erase(42);
+    EXPECT_EQ(single.rbegin(), single.rend());
+}
+
+TEST(SkipMapTest, Reverse)
+{
+    skip_map<int, std::string, random<float>>  smap(SRand);
+    for (int i = 0; i < 10; ++i)
+        smap[i] = std::to_string(i);
+    int expected = 9;
+    for (auto it = smap.rbegin(); it != smap.rend(); ++it, --expected)
+        EXPECT_EQ(std::to_string(expected), it->second);
+    EXPECT_EQ(-1, expected);
+    auto last = std::prev(smap.end());
+    last->second = "nine";
+    EXPECT_EQ("nine", smap.at(9));
+}
+
+TEST(SkipListEraseTest, ByIterator)
+{
+    std::mt19937 gen(17);
+    for (bool finger : { false, true })
+    {
+        std::set<int>  st;
+        skip_list<int, random<float>>  slist(SRand);
+        slist.finger_search(finger);
+        for (int i = 0; i < 5000; ++i)
+        {
+            int const key = int(gen() % 10000);
+            st.insert(key);
+            slist.insert(key);
+        }
+
+        // scan and delete, looking keys up in between to move the finger around
+        auto itS = std::begin(st);
+        for (auto it = std::begin(slist); it != std::end(slist);)
+        {
+            ASSERT_EQ(*itS, *it);
+            if (*it % 3 == 0)
+            {
+                itS = st.erase(itS);
+                it = slist.erase(it);
+            }
+            else
+            {
+                ++itS;
+                ++it;
+            }
+            EXPECT_EQ(st.count(*itS / 2), slist.count(*itS / 2));
+        }
+        EXPECT_EQ(std::end(st), itS);
+        ASSERT_EQ(st.size(), slist.size());
+        EXPECT_TRUE(std::equal(std::crbegin(st), std::crend(st), std::crbegin(slist), std::crend(slist)));
+
+        // the towers must still serve searches, inserts and erases
+        for (int i = 0; i < 10000; ++i)
+        {
+            EXPECT_EQ(st.count(i), slist.count(i));
+            if (i % 7 == 0)
+                EXPECT_EQ(st.insert(i).second, slist.insert(i).second);
+        }
+        while (!slist.empty())
+        {
+            EXPECT_EQ(*st.rbegin(), *slist.rbegin());
+            st.erase(std::prev(std::end(st)));
+            slist.erase(std::prev(std::cend(slist)));
+        }
+        EXPECT_EQ(std::begin(slist), std::end(slist));
+        slist.insert(1);
+        EXPECT_EQ(1, *std::prev(std::end(slist)));
+    }
+}
+
+TEST(SkipListEraseTest, Range)
+{
+    std::mt19937 gen(19);
+    for (bool finger : { false, true })
+    {
+        std::set<int>  st;
+        skip_list<int, random<float>>  slist(SRand);
+        slist.finger_search(finger);
+        for (int i = 0; i < 20000; ++i)
+        {
+            int const key = int(gen() % 50000);
+            st.insert(key);
+            slist.insert(key);
+        }
+        while (st.size() > 100)
+        {
+            int const lo = int(gen() % 50000);
+            int const hi = lo + int(gen() % 2000);
+            slist.contains(hi + 1); // leave the finger inside the run now and then
+            st.erase(st.lower_bound(lo), st.lower_bound(hi));
+            auto it = slist.erase(slist.lower_bound(lo), slist.lower_bound(hi));
+            EXPECT_EQ(slist.lower_bound(hi), it);
+            ASSERT_EQ(st.size(), slist.size());
+            EXPECT_EQ(st.count(lo - 1), slist.count(lo - 1));
+            EXPECT_EQ(st.count(hi), slist.count(hi));
+        }
+        EXPECT_TRUE(std::equal(std::cbegin(st), std::cend(st), std::cbegin(slist), std::cend(slist)));
+        EXPECT_TRUE(std::equal(std::crbegin(st), std::crend(st), std::crbegin(slist), std::crend(slist)));
+        for (int i = 0; i < 50000; i += 3)
+            EXPECT_EQ(st.insert(i).second, slist.insert(i).second);
+        EXPECT_TRUE(std::equal(std::cbegin(st), std::cend(st), std::cbegin(slist), std::cend(slist)));
+
+        EXPECT_EQ(std::end(slist), slist.erase(std::cbegin(slist), std::cend(slist)));
+        EXPECT_TRUE(slist.empty());
+        slist.insert(5);
+        EXPECT_EQ(5, *slist.rbegin());
+    }
+}
+
+TEST(SkipListEraseTest, EraseIf)
+{
+    skip_list<int, random<float>>  slist(SRand);
+    for (int i = 0; i < 10000; ++i)
+        slist.insert(i);
+    EXPECT_EQ(0, slist.erase_if([](int) { return false; }));
+    EXPECT_EQ(6666, slist.erase_if([](int v) { return v % 3 != 0; }));
+    ASSERT_EQ(3334, slist.size());
+    int expected = 0;
+    for (int v : slist)
+    {
+        EXPECT_EQ(expected, v);
+        expected += 3;
+    }
+    for (int i = 0; i < 10000; ++i)
+        EXPECT_EQ(i % 3 == 0, slist.contains(i));
+    EXPECT_EQ(3334, slist.erase_if([](int) { return true; }));
+    EXPECT_TRUE(slist.empty());
+
+    skip_map<int, int, random<float>>  smap(SRand);
+    for (int i = 0; i < 100; ++i)
+        smap[i] = i * i;
+    EXPECT_EQ(50, smap.erase_if([](std::pair<int const, int> const& v) { return v.second % 2 != 0; }));
+    smap.erase(smap.lower_bound(10), smap.lower_bound(90));
+    EXPECT_EQ(10, smap.size());
+    EXPECT_EQ(8100, smap.find(90)->second);
+    EXPECT_EQ(smap.end(), smap.find(88));
+}
+
+template <class SkipList>
+void expectIndexed(std::set<int> const& st, SkipList const& slist)
+{
+    ASSERT_EQ(st.size(), slist.size());
+    size_t k = 0;
+    for (auto it = std::cbegin(st); it != std::cend(st); ++it, ++k)
+    {
+        auto const pos = slist.nth(k);
+        ASSERT_NE(std::cend(slist), pos);
+        EXPECT_EQ(*it, *pos);
+        EXPECT_EQ(k, slist.index_of(pos));
+        EXPECT_EQ(k, slist.rank(*it));
+    }
+    EXPECT_EQ(std::cend(slist), slist.nth(st.size()));
+    EXPECT_EQ(st.size(), slist.index_of(std::cend(slist)));
+}
+
+TEST(IndexedSkipListTest, CompareWithSet)
+{
+    std::mt19937 gen(23);
+    std::set<int>  st;
+    indexed_skip_list<int, random<float>>  slist(SRand);
+    for (int round = 0; round < 6; ++round)
+    {
+        slist.finger_search(round % 2 != 0);
+        for (int i = 0; i < 3000; ++i)
+        {
+            int const key = int(gen() % 5000);
+            switch (gen() % 4)
+            {
+            case 0:
+            case 1:
+                EXPECT_EQ(st.insert(key).second, slist.insert(key).second);
+                break;
+            case 2:
+                EXPECT_EQ(st.erase(key), slist.erase(key));
+                break;
+            default:
+                auto it = slist.lower_bound(key);
+                if (it != std::end(slist))
+                {
+                    st.erase(*it);
+                    slist.erase(it);
+                }
+            }
+        }
+        expectIndexed(st, slist);
+
+        for (int lo = 0; lo < 5000; lo += 250)
+        {
+            int const hi = lo + int(gen() % 700);
+            EXPECT_EQ(std::distance(st.lower_bound(lo), st.lower_bound(hi)), slist.count_range(lo, hi));
+            EXPECT_EQ(std::distance(st.begin(), st.lower_bound(lo)), slist.rank(lo));
+            auto first = slist.lower_bound(lo);
+            auto last = slist.lower_bound(hi);
+            EXPECT_EQ(slist.count_range(lo, hi), slist.distance(first, last));
+            EXPECT_EQ(last, slist.advance(first, slist.distance(first, last)));
+            EXPECT_EQ(first, slist.advance(last, -slist.distance(first, last)));
+        }
+        EXPECT_EQ(0, slist.count_range(10, 10));
+        EXPECT_EQ(0, slist.count_range(10, 5));
+
+        // the bulk paths must keep the widths too
+        std::vector<int> batch;
+        for (int i = 0; i < 500; ++i)
+            batch.push_back(int(gen() % 5000));
+        st.insert(std::cbegin(batch), std::cend(batch));
+        slist.insert_batch(std::cbegin(batch), std::cend(batch));
+        expectIndexed(st, slist);
+
+        int const lo = int(gen() % 5000);
+        st.erase(st.lower_bound(lo), st.lower_bound(lo + 300));
+        slist.erase(slist.lower_bound(lo), slist.lower_bound(lo + 300));
+        expectIndexed(st, slist);
+
+        int const mod = round + 5;
+        for (auto it = std::begin(st); it != std::end(st);)
+            it = *it % mod == 0 ? st.erase(it) : std::next(it);
+        slist.erase_if([mod](int v) { return v % mod == 0; });
+        expectIndexed(st, slist);
+    }
+
+    std::vector<int> const sorted(std::cbegin(st), std::cend(st));
+    slist.assign_sorted(std::cbegin(sorted), std::cend(sorted));
+    expectIndexed(st, slist);
+}
+
+TEST(SkipListEraseTest, EraseIfRuns)
+{
+    // runs of erased keys at the front, inside and at the back, on an indexed list whose
+    // finger sits inside the runs
+    std::set<int>  st;
+    indexed_skip_list<int, random<float>>  slist(SRand, 0.5f);
+    slist.finger_search(true);
+    for (int i = 0; i < 5000; ++i)
+    {
+        st.insert(i);
+        slist.insert(i);
+    }
+    for (int round = 0; round < 4; ++round)
+    {
+        auto const pred = [round](int v) { return v < 300 || v >= 4700 - round * 100 || (v / (50 + round * 20)) % 3 == 1; };
+        EXPECT_EQ(st.count(1000), slist.count(1000));
+        size_t erased = 0;
+        for (auto it = std::begin(st); it != std::end(st);)
+        {
+            if (pred(*it))
+            {
+                it = st.erase(it);
+                ++erased;
+            }
+            else
+                ++it;
+        }
+        EXPECT_EQ(erased, slist.erase_if(pred));
+        expectIndexed(st, slist);
+        EXPECT_TRUE(std::equal(std::crbegin(st), std::crend(st), std::crbegin(slist), std::crend(slist)));
+        for (int key = round; key < 5000; key += 97)
+            EXPECT_EQ(st.insert(key).second, slist.insert(key).second);
+        expectIndexed(st, slist);
+    }
+    EXPECT_EQ(st.size(), slist.erase_if([](int) { return true; }));
+    EXPECT_TRUE(slist.empty());
+    slist.insert(3);
+    EXPECT_EQ(3, *slist.rbegin());
+}
+
+TEST(SkipListEraseTest, EraseIfThrows)
+{
+    // pred throws at a different element each round, in the middle of runs of erased keys
+    // and right after the first ones; the list must hold what was not erased yet
+    std::set<int>  st;
+    indexed_skip_list<int, random<float>>  slist(SRand, 0.5f);
+    slist.finger_search(true);
+    for (int i = 0; i < 3000; ++i)
+    {
+        st.insert(i);
+        slist.insert(i);
+    }
+    for (size_t calls : { 1000, 5, 1, 2, 777, 1500 })
+    {
+        EXPECT_EQ(st.count(500), slist.count(500));
+        size_t called = 0;
+        auto const pred = [&called, calls](int v)
+        {
+            if (++called == calls)
+                throw std::runtime_error("pred");
+            return v < 20 || (v / 40) % 3 != 0;
+        };
+        EXPECT_THROW(slist.erase_if(pred), std::runtime_error);
+
+        // the set loses the keys pred was asked about before it threw
+        called = 0;
+        for (auto it = std::begin(st); it != std::end(st) && called + 1 < calls;)
+        {
+            ++called;
+            it = *it < 20 || (*it / 40) % 3 != 0 ? st.erase(it) : std::next(it);
+        }
+        expectIndexed(st, slist);
+        EXPECT_TRUE(std::equal(std::crbegin(st), std::crend(st), std::crbegin(slist), std::crend(slist)));
+        for (int key = int(calls % 7); key < 3000; key += 13)
+            EXPECT_EQ(st.insert(key).second, slist.insert(key).second);
+        expectIndexed(st, slist);
+    }
+
+    skip_list<int, random<float>>  plain(SRand);
+    for (int i = 0; i < 100; ++i)
+        plain.insert(i);
+    int called = 0;
+    EXPECT_THROW(plain.erase_if([&called](int v) { if (++called == 60) throw std::runtime_error("pred"); return v % 2 == 0; }), std::runtime_error);
+    EXPECT_EQ(70, plain.size());
+    EXPECT_EQ(70, std::distance(std::cbegin(plain), std::cend(plain)));
+    for (int i = 0; i < 100; ++i)
+        EXPECT_EQ(i >= 59 || i % 2 != 0, plain.contains(i));
+}
+
+// every path that relinks nodes must refresh the keys cached beside the links
+template <class SkipList>
+void churnCached(SkipList& slist, std::set<int>& st, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    for (int round = 0; round < 4; ++round)
+    {
+        slist.finger_search(round % 2 != 0);
+        for (int i = 0; i < 3000; ++i)
+        {
+            int const key = int(gen() % 5000);
+            switch (gen() % 5)
+            {
+            case 0:
+            case 1:
+                EXPECT_EQ(st.insert(key).second, slist.insert(key).second);
+                break;
+            case 2:
+                st.insert(key);
+                EXPECT_EQ(key, *slist.insert(slist.lower_bound(key - 3), key));
+                break;
+            case 3:
+                EXPECT_EQ(st.erase(key), slist.erase(key));
+                break;
+            default:
+                EXPECT_EQ(st.count(key), slist.count(key));
+            }
+        }
+
+        std::vector<int> batch;
+        for (int i = 0; i < 300; ++i)
+            batch.push_back(int(gen() % 5000));
+        st.insert(std::cbegin(batch), std::cend(batch));
+        slist.insert_batch(std::cbegin(batch), std::cend(batch));
+
+        int const lo = int(gen() % 5000);
+        st.erase(st.lower_bound(lo), st.lower_bound(lo + 200));
+        slist.erase(slist.lower_bound(lo), slist.lower_bound(lo + 200));
+
+        int const mod = round + 7;
+        for (auto it = std::begin(st); it != std::end(st);)
+            it = *it % mod == 0 ? st.erase(it) : std::next(it);
+        slist.erase_if([mod](int v) { return v % mod == 0; });
+
+        ASSERT_EQ(st.size(), slist.size());
+        EXPECT_TRUE(std::equal(std::cbegin(st), std::cend(st), std::cbegin(slist), std::cend(slist)));
+        for (int key = -1; key <= 5000; ++key)
+        {
+            EXPECT_EQ(st.count(key), slist.count(key));
+            auto const itS = st.lower_bound(key);
+            auto const itL = slist.lower_bound(key);
+            ASSERT_EQ(itS == std::end(st), itL == std::end(slist));
+            if (itL != std::end(slist))
+                EXPECT_EQ(*itS, *itL);
+        }
+    }
+}
+
+TEST(CachedSkipListTest, CompareWithSet)
+{
+    std::set<int>  st;
+    cached_skip_list<int, random<float>>  slist(SRand);
+    churnCached(slist, st, 43);
+
+    std::vector<int> const sorted(std::cbegin(st), std::cend(st));
+    slist.assign_sorted(std::cbegin(sorted), std::cend(sorted));
+    for (int key = 0; key < 5000; ++key)
+        EXPECT_EQ(st.count(key), slist.count(key));
+}
+
+TEST(CachedSkipListTest, Indexed)
+{
+    std::set<int>  st;
+    skip_list<int, random<float>, std::less<int>, std::allocator<int>, coin_level, true, true>  slist(SRand);
+    churnCached(slist, st, 47);
+    expectIndexed(st, slist);
+}
+
+TEST(PrefetchSkipListTest, CompareWithSet)
+{
+    std::set<int>  st;
+    skip_list<int, random<float>, std::less<int>, std::allocator<int>, coin_level, false, false, link_prefetch<3>>  slist(SRand);
+    churnCached(slist, st, 53);
+
+    // prefetching iterators walk the list both ways like plain ones
+    auto itS = std::cbegin(st);
+    for (auto itL = std::cbegin(slist); itL != std::cend(slist); itL++, ++itS)
+        ASSERT_EQ(*itS, *itL);
+    EXPECT_TRUE(std::equal(std::crbegin(st), std::crend(st), std::crbegin(slist), std::crend(slist)));
+}
+
+template <class SkipList>
+void expectFindMany(SkipList& slist, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    for (int i = 0; i < 2000; ++i)
+        slist.insert(int(gen() % 4000));
+
+    // unsorted, repeated and absent keys, a count that is no multiple of the batch
+    std::vector<int> keys;
+    for (int i = 0; i < 1001; ++i)
+        keys.push_back(int(gen() % 4200) - 100);
+
+    SkipList const& cslist = slist;
+    for (bool finger : { false, true })
+    {
+        slist.finger_search(finger);
+        std::vector<typename SkipList::iterator> found(keys.size(), slist.begin());
+        EXPECT_EQ(std::end(found), slist.find_many(std::cbegin(keys), std::cend(keys), std::begin(found)));
+        std::vector<typename SkipList::const_iterator> cfound;
+        cslist.find_many(std::cbegin(keys), std::cend(keys), std::back_inserter(cfound));
+        std::vector<bool> contained;
+        cslist.contains_many(std::cbegin(keys), std::cend(keys), std::back_inserter(contained));
+
+        ASSERT_EQ(keys.size(), cfound.size());
+        ASSERT_EQ(keys.size(), contained.size());
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            EXPECT_EQ(slist.find(keys[i]), found[i]);
+            EXPECT_EQ(cslist.find(keys[i]), cfound[i]);
+            EXPECT_EQ(slist.contains(keys[i]), contained[i]);
+        }
+    }
+
+    std::vector<int> const none;
+    std::vector<bool> contained;
+    cslist.contains_many(std::cbegin(none), std::cend(none), std::back_inserter(contained));
+    EXPECT_TRUE(contained.empty());
+}
+
+TEST(SkipListFindManyTest, CompareWithFind)
+{
+    skip_list<int, random<float>>  slist(SRand);
+    expectFindMany(slist, 59);
+
+    cached_skip_list<int, random<float>>  cached(SRand);
+    expectFindMany(cached, 61);
+}
+
+TEST(SkipListFindManyTest, Sorted)
+{
+    std::mt19937 gen(67);
+    indexed_skip_list<int, random<float>>  slist(SRand);
+    for (int i = 0; i < 3000; ++i)
+        slist.insert(int(gen() % 6000));
+
+    // sorted keys with repeats and gaps, then a second sorted run that restarts the search
+    std::vector<int> keys;
+    for (int i = 0; i < 800; ++i)
+        keys.push_back(int(gen() % 6200) - 100);
+    std::sort(std::begin(keys), std::end(keys));
+    for (int key = 0; key < 6000; key += 37)
+        keys.push_back(key);
+
+    std::vector<indexed_skip_list<int, random<float>>::iterator> found(keys.size(), slist.end());
+    EXPECT_EQ(std::end(found), slist.find_sorted(std::cbegin(keys), std::cend(keys), std::begin(found)));
+    std::vector<indexed_skip_list<int, random<float>>::const_iterator> cfound;
+    static_cast<indexed_skip_list<int, random<float>> const&>(slist).find_sorted(std::cbegin(keys), std::cend(keys), std::back_inserter(cfound));
+
+    ASSERT_EQ(keys.size(), cfound.size());
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        EXPECT_EQ(slist.find(keys[i]), found[i]);
+        EXPECT_EQ(slist.find(keys[i]), cfound[i]);
+    }
+}
+
+// fills lhs and rhs with lhsCount and rhsCount random keys, checks their set algebra
+// against std::set, then merges rhs into lhs; st gets the keys of lhs and rhs those of rhs
+template <class SkipList>
+void expectSetAlgebra(SkipList& lhs, SkipList& rhs, int lhsCount, int rhsCount, unsigned seed,
+    std::set<int>& stL, std::set<int>& stR)
+{
+    std::mt19937 gen(seed);
+    for (int i = 0; i < lhsCount; ++i)
+    {
+        int const key = int(gen() % 6000);
+        EXPECT_EQ(stL.insert(key).second, lhs.insert(key).second);
+    }
+    for (int i = 0; i < rhsCount; ++i)
+    {
+        int const key = int(gen() % 6000);
+        EXPECT_EQ(stR.insert(key).second, rhs.insert(key).second);
+    }
+
+    for (bool swapped : { false, true })
+    {
+        SkipList const& a = swapped ? rhs : lhs;
+        SkipList const& b = swapped ? lhs : rhs;
+        std::set<int> const& stA = swapped ? stR : stL;
+        std::set<int> const& stB = swapped ? stL : stR;
+        std::vector<int> expected;
+        std::vector<int> result;
+
+        std::set_union(std::cbegin(stA), std::cend(stA), std::cbegin(stB), std::cend(stB), std::back_inserter(expected));
+        a.set_union(b, std::back_inserter(result));
+        EXPECT_EQ(expected, result);
+
+        expected.clear();
+        result.clear();
+        std::set_intersection(std::cbegin(stA), std::cend(stA), std::cbegin(stB), std::cend(stB), std::back_inserter(expected));
+        a.set_intersection(b, std::back_inserter(result));
+        EXPECT_EQ(expected, result);
+
+        expected.clear();
+        result.clear();
+        std::set_difference(std::cbegin(stA), std::cend(stA), std::cbegin(stB), std::cend(stB), std::back_inserter(expected));
+        a.set_difference(b, std::back_inserter(result));
+        EXPECT_EQ(expected, result);
+    }
+
+    // the keys lhs already has stay in rhs
+    std::set<int> kept;
+    std::set_intersection(std::cbegin(stL), std::cend(stL), std::cbegin(stR), std::cend(stR), std::inserter(kept, std::end(kept)));
+    stL.insert(std::cbegin(stR), std::cend(stR));
+    stR.swap(kept);
+    lhs.merge(rhs);
+
+    ASSERT_EQ(stL.size(), lhs.size());
+    ASSERT_EQ(stR.size(), rhs.size());
+    EXPECT_TRUE(std::equal(std::cbegin(stL), std::cend(stL), std::cbegin(lhs), std::cend(lhs)));
+    EXPECT_TRUE(std::equal(std::cbegin(stR), std::cend(stR), std::cbegin(rhs), std::cend(rhs)));
+    EXPECT_TRUE(std::equal(std::crbegin(stL), std::crend(stL), std::crbegin(lhs), std::crend(lhs)));
+    EXPECT_TRUE(std::equal(std::crbegin(stR), std::crend(stR), std::crbegin(rhs), std::crend(rhs)));
+    for (int key = -1; key <= 6000; key += 3)
+    {
+        EXPECT_EQ(stL.count(key), lhs.count(key));
+        EXPECT_EQ(stR.count(key), rhs.count(key));
+    }
+    // both lists go on working after the nodes changed hands
+    for (int key = 0; key < 6000; key += 7)
+    {
+        EXPECT_EQ(stL.erase(key), lhs.erase(key));
+        EXPECT_EQ(stR.insert(key).second, rhs.insert(key).second);
+    }
+    EXPECT_TRUE(std::equal(std::cbegin(stL), std::cend(stL), std::cbegin(lhs), std::cend(lhs)));
+    EXPECT_TRUE(std::equal(std::cbegin(stR), std::cend(stR), std::cbegin(rhs), std::cend(rhs)));
+}
+
+TEST(SkipListSetTest, Algebra)
+{
+    int const counts[][2] = { { 2000, 2000 }, { 40, 3000 }, { 3000, 40 }, { 0, 500 }, { 500, 0 } };
+    unsigned seed = 71;
+    for (auto const& count : counts)
+    {
+        for (bool finger : { false, true })
+        {
+            skip_list<int, random<float>>  lhs(SRand);
+            skip_list<int, random<float>>  rhs(SRand);
+            lhs.finger_search(finger);
+            rhs.finger_search(finger);
+            std::set<int>  stL;
+            std::set<int>  stR;
+            expectSetAlgebra(lhs, rhs, count[0], count[1], ++seed, stL, stR);
+        }
+    }
+}
+
+TEST(SkipListSetTest, IndexedCachedMerge)
+{
+    // towers of rhs grow taller than those of lhs with the higher prob
+    skip_list<int, random<float>, std::less<int>, std::allocator<int>, coin_level, true, true>  lhs(SRand, 0.1f);
+    skip_list<int, random<float>, std::less<int>, std::allocator<int>, coin_level, true, true>  rhs(SRand, 0.7f);
+    std::set<int>  stL;
+    std::set<int>  stR;
+    expectSetAlgebra(lhs, rhs, 300, 3000, 79, stL, stR);
+    expectIndexed(stL, lhs);
+    expectIndexed(stR, rhs);
+}
+
+TEST(SkipListSetTest, PoolMerge)
+{
+    typedef skip_list<int, random<float>, std::less<int>, pool_allocator<int>> pool_slist;
+    std::set<int>  stL;
+    std::set<int>  stR;
+    {
+        // separate pools: the keys are copied
+        pool_slist  lhs(SRand);
+        pool_slist  rhs(SRand);
+        expectSetAlgebra(lhs, rhs, 1000, 1000, 83, stL, stR);
+    }
+
+    stL.clear();
+    stR.clear();
+    pool_allocator<int>  alloc;
+    pool_slist  lhs(SRand, 0.5f, std::less<int>(), alloc);
+    {
+        // a shared pool: the nodes move and outlive the list they came from
+        pool_slist  rhs(SRand, 0.5f, std::less<int>(), alloc);
+        expectSetAlgebra(lhs, rhs, 1000, 1000, 89, stL, stR);
+    }
+    EXPECT_TRUE(std::equal(std::cbegin(stL), std::cend(stL), std::cbegin(lhs), std::cend(lhs)));
+}
+
+template <class SkipList>
+void expectSameKeys(std::set<int> const& st, SkipList const& slist)
+{
+    ASSERT_EQ(st.size(), slist.size());
+    EXPECT_EQ(st.empty(), slist.empty());
+    EXPECT_TRUE(std::equal(std::cbegin(st), std::cend(st), std::cbegin(slist), std::cend(slist)));
+    EXPECT_TRUE(std::equal(std::crbegin(st), std::crend(st), std::crbegin(slist), std::crend(slist)));
+}
+
+// splits slist at keys below, inside and above its range, checks the pieces, changes them
+// and joins them back in either order; check is called on every piece with its keys
+template <class SkipList, class Check>
+void expectSplitJoin(SkipList& slist, unsigned seed, Check check)
+{
+    std::mt19937 gen(seed);
+    std::set<int>  st;
+    for (int i = 0; i < 3000; ++i)
+    {
+        int const key = int(gen() % 8000);
+        EXPECT_EQ(st.insert(key).second, slist.insert(key).second);
+    }
+
+    for (int cut : { -5, 0, 1, 2500, 4001, 7999, 8000, 9000 })
+    {
+        std::set<int> stRight(st.lower_bound(cut), std::end(st));
+        st.erase(st.lower_bound(cut), std::end(st));
+        SkipList right = slist.split(cut);
+        expectSameKeys(st, slist);
+        expectSameKeys(stRight, right);
+        check(st, slist);
+        check(stRight, right);
+
+        // both pieces take keys on their side of the cut
+        for (int i = 0; i < 200; ++i)
+        {
+            int const key = int(gen() % 8000);
+            if (key < cut)
+                EXPECT_EQ(st.insert(key).second, slist.insert(key).second);
+            else
+                EXPECT_EQ(stRight.erase(key), right.erase(key));
+        }
+        expectSameKeys(st, slist);
+        expectSameKeys(stRight, right);
+
+        if (cut % 2)
+        {
+            slist.join(right);
+            EXPECT_TRUE(right.empty());
+        }
+        else
+        {
+            right.join(slist);
+            EXPECT_TRUE(slist.empty());
+            slist.swap(right);
+        }
+        st.insert(std::cbegin(stRight), std::cend(stRight));
+        expectSameKeys(st, slist);
+        check(st, slist);
+        for (int key = -1; key <= 8000; key += 5)
+            EXPECT_EQ(st.count(key), slist.count(key));
+    }
+
+    // the keys of other fall inside the range of slist
+    SkipList other = slist.split(4000);
+    other.insert(10);
+    EXPECT_THROW(slist.join(other), std::invalid_argument);
+    EXPECT_THROW(other.join(slist), std::invalid_argument);
+    other.erase(10);
+    slist.join(other);
+    expectSameKeys(st, slist);
+}
+
+TEST(SkipListSplitTest, SplitJoin)
+{
+    auto const check = [](std::set<int> const& st, indexed_skip_list<int, random<float>> const& piece) { expectIndexed(st, piece); };
+    indexed_skip_list<int, random<float>>  slist(SRand);
+    expectSplitJoin(slist, 97, check);
+
+    indexed_skip_list<int, random<float>>  finger(SRand);
+    finger.finger_search(true);
+    expectSplitJoin(finger, 101, check);
+}
+
+TEST(SkipListSplitTest, JoinPlain)
+{
+    // only joins, a plain list cannot be split
+    std::set<int>  st;
+    skip_list<int, random<float>>  lhs(SRand);
+    for (int base : { 0, 3000, -2000, 1000 })
+    {
+        skip_list<int, random<float>>  rhs(SRand);
+        for (int i = base; i < base + 1000; i += 3)
+            rhs.insert(i);
+        if (base == 1000)
+        {
+            // rhs would go in the middle of lhs
+            EXPECT_THROW(lhs.join(rhs), std::invalid_argument);
+            break;
+        }
+        for (int i = base; i < base + 1000; i += 3)
+            st.insert(i);
+        lhs.join(rhs);
+        EXPECT_TRUE(rhs.empty());
+        expectSameKeys(st, lhs);
+    }
+    expectSameKeys(st, lhs);
+}
+
+TEST(SkipListSplitTest, IndexedCached)
+{
+    typedef skip_list<int, random<float>, std::less<int>, std::allocator<int>, coin_level, true, true> indexed_cached;
+    indexed_cached  slist(SRand, 0.25f);
+    expectSplitJoin(slist, 103, [](std::set<int> const& st, indexed_cached const& piece) { expectIndexed(st, piece); });
+}
+
+TEST(SkipListSplitTest, Move)
+{
+    skip_list<int, random<float>>  slist(SRand);
+    for (int i = 0; i < 100; ++i)
+        slist.insert(i);
+    skip_list<int, random<float>>  moved(std::move(slist));
+    EXPECT_TRUE(slist.empty());
+    EXPECT_EQ(100, moved.size());
+    EXPECT_EQ(99, *moved.rbegin());
+    slist.insert(5);
+    EXPECT_EQ(1, slist.size());
+}
+
+template <size_t NodeKeys, class SkipList>
+void churnUnrolled(SkipList& slist, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::set<int>  st;
+    for (int round = 0; round < 4; ++round)
+    {
+        for (int i = 0; i < 4000; ++i)
+        {
+            int const key = int(gen() % 3000);
+            switch (gen() % 4)
+            {
+            case 0:
+            case 1:
+                EXPECT_EQ(st.insert(key).second, slist.insert(key).second);
+                break;
+            case 2:
+                EXPECT_EQ(st.erase(key), slist.erase(key));
+                break;
+            default:
+                auto it = slist.lower_bound(key);
+                if (it != std::end(slist))
+                {
+                    auto const next = st.erase(st.find(*it));
+                    it = slist.erase(it);
+                    EXPECT_EQ(next == std::end(st), it == std::end(slist));
+                    if (next != std::end(st))
+                        EXPECT_EQ(*next, *it);
+                }
+            }
+        }
+        ASSERT_EQ(st.size(), slist.size());
+        EXPECT_TRUE(std::equal(std::cbegin(st), std::cend(st), std::cbegin(slist), std::cend(slist)));
+        EXPECT_TRUE(std::equal(std::crbegin(st), std::crend(st), std::crbegin(slist), std::crend(slist)));
+        // nodes split in halves and never stay below a quarter full but at the back
+        EXPECT_LE(slist.size(), slist.nodes() * NodeKeys);
+        EXPECT_GE(slist.size() + NodeKeys, slist.nodes() * (NodeKeys / 4));
+
+        for (int key = -1; key <= 3000; ++key)
+        {
+            EXPECT_EQ(st.count(key), slist.count(key));
+            auto const lower = slist.lower_bound(key);
+            auto const upper = slist.upper_bound(key);
+            EXPECT_EQ(st.lower_bound(key) == std::end(st), lower == std::end(slist));
+            EXPECT_EQ(st.upper_bound(key) == std::end(st), upper == std::end(slist));
+            if (lower != std::end(slist))
+                EXPECT_EQ(*st.lower_bound(key), *lower);
+            if (upper != std::end(slist))
+                EXPECT_EQ(*st.upper_bound(key), *upper);
+            EXPECT_EQ(slist.equal_range(key), std::make_pair(lower, upper));
+        }
+    }
+
+    // drain from both ends
+    while (!slist.empty())
+    {
+        EXPECT_EQ(*st.begin(), *slist.begin());
+        EXPECT_EQ(*st.rbegin(), *slist.rbegin());
+        st.erase(st.begin());
+        slist.erase(std::begin(slist));
+        if (!st.empty())
+        {
+            st.erase(std::prev(std::end(st)));
+            slist.erase(std::prev(std::cend(slist)));
+        }
+    }
+    EXPECT_TRUE(st.empty());
+    EXPECT_EQ(0, slist.nodes());
+    EXPECT_EQ(std::begin(slist), std::end(slist));
+}
+
+TEST(UnrolledSkipListTest, CompareWithSet)
+{
+    unrolled_skip_list<int, random<float>>  slist(SRand);
+    churnUnrolled<32>(slist, 29);
+    // nodes of 4 keys split and merge all the time
+    unrolled_skip_list<int, random<float>, std::less<int>, std::allocator<int>, coin_level, 4>  small(SRand);
+    churnUnrolled<4>(small, 31);
+}
+
+TEST(UnrolledSkipListTest, Ascending)
+{
+    // appending starts new nodes instead of splitting full ones
+    unrolled_skip_list<int, random<float>>  slist(SRand);
+    for (int i = 0; i < 3200; ++i)
+        EXPECT_TRUE(slist.insert(i).second);
+    EXPECT_EQ(100, slist.nodes());
+    EXPECT_FALSE(slist.insert(1000).second);
+    EXPECT_EQ(1000, *slist.find(1000));
+    EXPECT_EQ(std::end(slist), slist.find(3200));
+}
+
+TEST(UnrolledSkipListTest, Strings)
+{
+    // keys that are not trivially copyable are moved between the nodes one by one
+    unrolled_skip_list<std::string, random<float>, std::less<>, pool_allocator<std::string>, coin_level, 8>  slist(SRand);
+    std::set<std::string>  st;
+    for (int i = 0; i < 2000; ++i)
+    {
+        std::string const key = std::to_string(i * 7919 % 2000) + std::string(20, 'x');
+        EXPECT_EQ(st.insert(key).second, slist.emplace(key).second);
+        if (i % 3 == 0)
+            EXPECT_EQ(st.erase(std::to_string(i) + std::string(20, 'x')), slist.erase(std::to_string(i) + std::string(20, 'x')));
+    }
+    EXPECT_TRUE(std::equal(std::cbegin(st), std::cend(st), std::cbegin(slist), std::cend(slist)));
+    EXPECT_TRUE(slist.contains("1999xxxxxxxxxxxxxxxxxxxx"));
+    EXPECT_EQ(st.count("1xxxxxxxxxxxxxxxxxxxx"), slist.count("1xxxxxxxxxxxxxxxxxxxx"));
+    slist.clear();
+    EXPECT_TRUE(slist.empty());
+    slist.insert({ "b", "a", "c" });
+    EXPECT_EQ("a", *slist.begin());
+    EXPECT_EQ("c", *slist.rbegin());
+}
+
+template <class Key, class Compare>
+void expectKeySearch(unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::vector<Key> keys;
+    for (size_t count = 0; count <= 70; ++count)
+    {
+        // a spread over the extremes of Key, with gaps to look up in between
+        keys.clear();
+        for (size_t i = 0; i < count; ++i)
+            keys.push_back(Key(gen() % 200) - 100);
+        keys.push_back(std::numeric_limits<Key>::min());
+        keys.push_back(std::numeric_limits<Key>::max());
+        std::sort(std::begin(keys), std::end(keys));
+        keys.erase(std::unique(std::begin(keys), std::end(keys)), std::end(keys));
+
+        std::vector<Key> probes(std::cbegin(keys), std::cend(keys));
+        for (Key k = -102; k <= 102; ++k)
+            probes.push_back(k);
+        for (Key const key : probes)
+        {
+            size_t const lower = std::lower_bound(std::cbegin(keys), std::cend(keys), key) - std::cbegin(keys);
+            size_t const upper = std::upper_bound(std::cbegin(keys), std::cend(keys), key) - std::cbegin(keys);
+            EXPECT_EQ(lower, (key_search<Key, Compare>::lower(keys.data(), keys.size(), key, Compare())));
+            EXPECT_EQ(upper, (key_search<Key, Compare>::upper(keys.data(), keys.size(), key, Compare())));
+        }
+    }
+}
+
+TEST(KeySearchTest, MatchesBinarySearch)
+{
+    // vectorized where the target allows it, scalar for the rest
+    expectKeySearch<int, std::less<int>>(37);
+    expectKeySearch<int, std::less<>>(38);
+    expectKeySearch<std::int64_t, std::less<std::int64_t>>(39);
+    expectKeySearch<long long, std::less<long long>>(40);
+    expectKeySearch<short, std::less<short>>(41);
+    EXPECT_FALSE((simd_searchable<int, std::greater<int>>::value));
+    EXPECT_FALSE((simd_searchable<unsigned, std::less<unsigned>>::value));
+}
+
+// orders events by their time only, the ids tell equal events apart
+struct event_time_less
+{
+    bool operator()(std::pair<int, int> const& lhs, std::pair<int, int> const& rhs) const
+    {
+        return lhs.first < rhs.first;
+    }
+};
+
+TEST(SkipMultisetTest, CompareWithMultiset)
+{
+    typedef std::pair<int, int> event;
+    std::multiset<event, event_time_less>  st;
+    skip_multiset<event, random<float>, event_time_less>  mset(SRand);
+    std::mt19937 gen(107);
+    int id = 0;
+    for (int round = 0; round < 6; ++round)
+    {
+        for (int i = 0; i < 2000; ++i)
+        {
+            int const time = int(gen() % 300);
+            switch (gen() % 6)
+            {
+            case 0:
+            case 1:
+                EXPECT_EQ(*st.insert(event(time, id)), *mset.insert(event(time, id)));
+                ++id;
+                break;
+            case 2:
+                EXPECT_EQ(*st.emplace(time, id), *mset.emplace(time, id));
+                ++id;
+                break;
+            case 3:
+            {
+                // a run of equal keys, sorted or not
+                std::vector<event> run;
+                for (int k = int(gen() % 20); k > 0; --k)
+                    run.push_back(event(round % 2 ? time : int(gen() % 300), id++));
+                st.insert(std::cbegin(run), std::cend(run));
+                mset.insert(std::cbegin(run), std::cend(run));
+                break;
+            }
+            case 4:
+                if (gen() % 8 == 0)
+                {
+                    EXPECT_EQ(st.erase(event(time, 0)), mset.erase(event(time, 0)));
+                }
+                else if (st.find(event(time, 0)) != std::end(st))
+                {
+                    st.erase(st.find(event(time, 0)));
+                    mset.erase(mset.find(event(time, 0)));
+                }
+                break;
+            default:
+                EXPECT_EQ(st.count(event(time, 0)), mset.count(event(time, 0)));
+            }
+        }
+
+        ASSERT_EQ(st.size(), mset.size());
+        EXPECT_TRUE(std::equal(std::cbegin(st), std::cend(st), std::cbegin(mset), std::cend(mset)));
+        EXPECT_TRUE(std::equal(std::crbegin(st), std::crend(st), std::crbegin(mset), std::crend(mset)));
+        for (int time = -1; time <= 300; ++time)
+        {
+            auto const rangeS = st.equal_range(event(time, 0));
+            auto const rangeM = mset.equal_range(event(time, 0));
+            EXPECT_TRUE(std::equal(rangeS.first, rangeS.second, rangeM.first, rangeM.second));
+            EXPECT_EQ(rangeM.first, mset.lower_bound(event(time, 0)));
+            EXPECT_EQ(rangeM.second, mset.upper_bound(event(time, 0)));
+            EXPECT_EQ(st.count(event(time, 0)), mset.count(event(time, 0)));
+            EXPECT_EQ(rangeS.first != rangeS.second, mset.contains(event(time, 0)));
+        }
+    }
+
+    mset.erase(mset.cbegin(), mset.lower_bound(event(150, 0)));
+    st.erase(std::cbegin(st), st.lower_bound(event(150, 0)));
+    EXPECT_TRUE(std::equal(std::cbegin(st), std::cend(st), std::cbegin(mset), std::cend(mset)));
+    mset.clear();
+    EXPECT_TRUE(mset.empty());
+}
+
+TEST(SkipMultisetTest, EqualRun)
+{
+    skip_multiset<int, random<float>>  mset(SRand);
+    std::vector<int> const run(5000, 7);
+    mset.insert({ 1, 9, 7, 3 });
+    mset.insert(std::cbegin(run), std::cend(run));
+    mset.insert(7);
+    EXPECT_EQ(5005u, mset.size());
+    EXPECT_EQ(5002u, mset.count(7));
+    EXPECT_EQ(3, *std::prev(mset.lower_bound(7)));
+    EXPECT_EQ(9, *mset.upper_bound(7));
+    EXPECT_EQ(5002u, mset.erase(7));
+    std::vector<int> const rest{ 1, 3, 9 };
+    EXPECT_TRUE(std::equal(std::cbegin(rest), std::cend(rest), std::cbegin(mset), std::cend(mset)));
+}
+
 #endif